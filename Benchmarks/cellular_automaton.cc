@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../Source/cellular_automaton.hpp"
+
+namespace {
+template <typename Function> double seconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// Rule 30 and Life generations with per-cell dynamic_bitset reads compared
+// to the word kernels with adder logic, Life also on all threads.
+int main() {
+  const std::size_t cells = 1 << 16, steps = 200;
+  std::size_t plain_rule = 0;
+  const double plain_1d = seconds([&] {
+    dynamic_bitset<> row(std::vector<bool>(cells, false));
+    row[cells / 2] = true;
+    for (std::size_t step = 0; step < steps; ++step) {
+      std::vector<bool> next(cells);
+      for (std::size_t i = 0; i < cells; ++i) {
+        const bool left = i > 0 && row[i - 1];
+        const bool right = i + 1 < cells && row[i + 1];
+        next[i] = (30 >> (left * 4 + row[i] * 2 + right)) & 1;
+      }
+      row = next;
+    }
+    for (std::size_t i = 0; i < cells; ++i)
+      plain_rule += row[i];
+  });
+  std::size_t word_rule = 0;
+  const double word_1d = seconds([&] {
+    word_bitset row(cells);
+    row.set(cells / 2, true);
+    for (std::size_t step = 0; step < steps; ++step)
+      row = elementary_step<30>(row);
+    word_rule = row.count();
+  });
+
+  const std::size_t size = 1024, generations = 50;
+  bit_matrix grid(size, size);
+  for (std::size_t i = 0; i < size; ++i)
+    for (std::size_t j = 0; j < size; ++j)
+      grid.set(i, j, bit_word::mix(i * size + j) % 3 == 0);
+
+  std::size_t plain_life = 0;
+  const double plain_2d = seconds([&] {
+    std::vector<dynamic_bitset<>> rows;
+    for (std::size_t i = 0; i < size; ++i)
+      rows.push_back(grid[i].to_dynamic_bitset());
+    for (std::size_t generation = 0; generation < generations; ++generation) {
+      std::vector<dynamic_bitset<>> next;
+      for (std::size_t i = 0; i < size; ++i) {
+        std::vector<bool> row(size);
+        for (std::size_t j = 0; j < size; ++j) {
+          int count = 0;
+          for (std::size_t r = i ? i - 1 : 0; r <= i + 1 && r < size; ++r)
+            for (std::size_t c = j ? j - 1 : 0; c <= j + 1 && c < size; ++c)
+              count += (r != i || c != j) && rows[r][c];
+          row[j] = count == 3 || (count == 2 && rows[i][j]);
+        }
+        next.emplace_back(std::move(row));
+      }
+      rows = std::move(next);
+    }
+    for (const auto &row : rows)
+      for (std::size_t j = 0; j < size; ++j)
+        plain_life += row[j];
+  });
+
+  const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t serial_life = 0, parallel_life = 0;
+  const double serial_2d = seconds([&] {
+    bit_matrix state = grid;
+    for (std::size_t generation = 0; generation < generations; ++generation)
+      state = life_step(state);
+    for (std::size_t i = 0; i < size; ++i)
+      serial_life += state[i].count();
+  });
+  const double parallel_2d = seconds([&] {
+    bit_matrix state = grid;
+    for (std::size_t generation = 0; generation < generations; ++generation)
+      state = life_step(state, false, threads);
+    for (std::size_t i = 0; i < size; ++i)
+      parallel_life += state[i].count();
+  });
+
+  std::cout << "rule 30, " << cells << " cells, " << steps << " steps\n";
+  std::cout << "dynamic_bitset cells   " << plain_1d << " s\n";
+  std::cout << "elementary_step<30>    " << word_1d << " s ("
+            << plain_1d / word_1d << "x)\n";
+  std::cout << "life, " << size << " x " << size << ", " << generations
+            << " generations\n";
+  std::cout << "dynamic_bitset cells   " << plain_2d << " s\n";
+  std::cout << "life_step 1 thread     " << serial_2d << " s ("
+            << plain_2d / serial_2d << "x)\n";
+  std::cout << "life_step " << threads << " threads    " << parallel_2d
+            << " s (" << plain_2d / parallel_2d << "x)\n";
+  return plain_rule == word_rule && plain_life == serial_life &&
+                 serial_life == parallel_life
+             ? 0
+             : 1;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "../Source/persistent_bitset.hpp"
+
+namespace {
+template <typename Function> double seconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// Durable update throughput: every group of updates is made durable either
+// by rewriting and syncing the whole image or by one write-ahead log append.
+int main() {
+  const std::size_t size = std::size_t(1) << 26;
+  const std::size_t groups = 50, group = 1000;
+  const std::string image = "persistent_bitset_benchmark.bin";
+  const std::string copy = "persistent_bitset_benchmark_rewrite.bin";
+  std::remove(image.c_str());
+  std::remove((image + ".log").c_str());
+
+  word_bitset rewritten(size);
+  const double rewrite = seconds([&] {
+    for (std::size_t g = 0; g < groups; ++g) {
+      for (std::size_t k = 0; k < group; ++k)
+        rewritten.set(bit_word::mix(g * group + k) % size, true);
+      std::FILE *file = persistent_io::open(copy, "wb");
+      persistent_io::write(file, rewritten.data(), rewritten.word_count());
+      persistent_io::sync(file);
+      std::fclose(file);
+    }
+  });
+
+  double logged = 0, checkpoint = 0;
+  std::size_t logged_count = 0;
+  {
+    persistent_bitset bits(image, size, group);
+    logged = seconds([&] {
+      for (std::size_t g = 0; g < groups; ++g)
+        for (std::size_t k = 0; k < group; ++k)
+          bits.set(bit_word::mix(g * group + k) % size);
+    });
+    checkpoint = seconds([&] { bits.checkpoint(); });
+    logged_count = bits.count();
+  }
+
+  const double updates = static_cast<double>(groups * group);
+  std::cout << groups << " groups of " << group << " updates on " << size
+            << " bits\n";
+  std::cout << "full rewrite       " << rewrite << " s, "
+            << updates / rewrite << " updates/s\n";
+  std::cout << "write-ahead log    " << logged << " s, " << updates / logged
+            << " updates/s (" << rewrite / logged << "x), final checkpoint "
+            << checkpoint << " s\n";
+  std::remove(image.c_str());
+  std::remove((image + ".log").c_str());
+  std::remove(copy.c_str());
+  return logged_count == rewritten.count() ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../Source/prime_sieve.hpp"
+
+namespace {
+template <typename Function> double seconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// End to end prime table workload: a plain sieve on dynamic_bitset compared
+// to the odd-only segmented prime_sieve with one and with all threads.
+int main() {
+  const std::size_t limit = 100000000;
+
+  std::size_t plain_count = 0;
+  const double plain = seconds([&] {
+    dynamic_bitset<> composite(std::vector<bool>(limit + 1, false));
+    for (std::size_t p = 2; p * p <= limit; ++p)
+      if (!composite[p])
+        for (std::size_t m = p * p; m <= limit; m += p)
+          composite[m] = true;
+    for (std::size_t n = 2; n <= limit; ++n)
+      plain_count += !composite[n];
+  });
+
+  std::size_t serial_count = 0;
+  const double serial =
+      seconds([&] { serial_count = prime_sieve(limit, 1).count(); });
+
+  const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t parallel_count = 0;
+  const double parallel =
+      seconds([&] { parallel_count = prime_sieve(limit, threads).count(); });
+
+  std::cout << "limit " << limit << ", primes " << serial_count << "\n";
+  std::cout << "dynamic_bitset sieve   " << plain << " s\n";
+  std::cout << "prime_sieve 1 thread   " << serial << " s ("
+            << plain / serial << "x)\n";
+  std::cout << "prime_sieve " << threads << " threads  " << parallel << " s ("
+            << plain / parallel << "x)\n";
+  return plain_count == serial_count && serial_count == parallel_count ? 0
+                                                                        : 1;
+}
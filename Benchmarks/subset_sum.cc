@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "../Source/subset_sum.hpp"
+
+namespace {
+template <typename Function> double seconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// Subset sum step reachable |= reachable << w with dynamic_bitset shifts
+// compared to the fused word_bitset::or_shifted.
+int main() {
+  const std::size_t capacity = 20000;
+  std::vector<std::size_t> weights;
+  for (std::size_t i = 0; i < 200; ++i)
+    weights.push_back(1 + bit_word::mix(i) % 1000);
+
+  bool serial_result = false;
+  const double serial = seconds([&] {
+    // index 0 is the most significant bit, sum s lives at capacity - s
+    dynamic_bitset<> reachable(std::vector<bool>(capacity + 1, false));
+    reachable[capacity] = true;
+    for (std::size_t weight : weights) {
+      dynamic_bitset<> shifted(reachable.get());
+      shifted <<= weight;
+      reachable |= shifted;
+    }
+    serial_result = reachable[0];
+  });
+
+  bool fused_result = false;
+  const double fused = seconds([&] {
+    word_bitset reachable(capacity + 1);
+    reachable.set(0, true);
+    for (std::size_t weight : weights)
+      reachable.or_shifted(reachable, weight);
+    fused_result = reachable.test(capacity);
+  });
+
+  bool split_result = false;
+  const double split =
+      seconds([&] { split_result = subset_sum(weights, capacity); });
+
+  std::cout << "weights " << weights.size() << ", capacity " << capacity
+            << "\n";
+  std::cout << "dynamic_bitset <<= |=  " << serial << " s\n";
+  std::cout << "or_shifted             " << fused << " s ("
+            << serial / fused << "x)\n";
+  std::cout << "subset_sum             " << split << " s\n";
+  return serial_result == fused_result && fused_result == split_result ? 0
+                                                                        : 1;
+}
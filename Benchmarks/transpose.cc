@@ -0,0 +1,41 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+#include "../Source/bit_transpose.hpp"
+
+namespace {
+template <typename Function> double seconds(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// Transpose of a 4096 x 4096 bit matrix bit by bit compared to the blocked
+// 64 x 64 kernels.
+int main() {
+  const std::size_t size = 4096;
+  bit_matrix matrix(size, size);
+  for (std::size_t i = 0; i < size; ++i)
+    for (std::size_t w = 0; w < matrix.words_per_row(); ++w)
+      matrix.row_data(i)[w] = bit_word::mix(i * size + w);
+
+  bit_matrix serial_result(size, size);
+  const double serial = seconds([&] {
+    for (std::size_t i = 0; i < size; ++i)
+      for (std::size_t j = 0; j < size; ++j)
+        serial_result[j].set(i, matrix[i][j]);
+  });
+
+  bit_matrix blocked_result(0, 0);
+  const double blocked = seconds([&] { blocked_result = transpose(matrix); });
+
+  std::cout << "matrix " << size << " x " << size << "\n";
+  std::cout << "bit by bit  " << serial << " s\n";
+  std::cout << "blocked     " << blocked << " s (" << serial / blocked
+            << "x)\n";
+  return serial_result == blocked_result ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+#ifndef BIT_ARITHMETIC_H_
+#define BIT_ARITHMETIC_H_
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Unsigned multi-word arithmetic on little endian word sequences,
+ * word 0 holding the least significant 64 bits.
+ *
+ * The kernels chain adc / sbb over the words and allow out to alias a or b.
+ */
+namespace bit_arithmetic {
+using word_type = bit_word::word_type;
+
+/**
+ * @brief out = a + b + carry over count words.
+ * @return Carry out of the most significant word.
+ */
+inline unsigned char add_with_carry(word_type *out, const word_type *a,
+                                    const word_type *b, std::size_t count,
+                                    unsigned char carry = 0) {
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = bit_word::add_carry(a[i], b[i], carry);
+  return carry;
+}
+
+/**
+ * @brief out = a - b - borrow over count words.
+ * @return Borrow out of the most significant word, set when a < b.
+ */
+inline unsigned char sub_with_borrow(word_type *out, const word_type *a,
+                                     const word_type *b, std::size_t count,
+                                     unsigned char borrow = 0) {
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = bit_word::sub_borrow(a[i], b[i], borrow);
+  return borrow;
+}
+
+/**
+ * @brief Add one, stopping at the first word that does not overflow.
+ * @return Carry out, set when every word was all ones.
+ */
+inline unsigned char increment(word_type *words, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i)
+    if (++words[i] != 0)
+      return 0;
+  return 1;
+}
+
+/**
+ * @brief Two's complement negation, -x modulo 2^(64 * count).
+ */
+inline void negate(word_type *words, std::size_t count) {
+  unsigned char borrow = 0;
+  for (std::size_t i = 0; i < count; ++i)
+    words[i] = bit_word::sub_borrow(0, words[i], borrow);
+}
+
+/**
+ * @brief Unsigned comparison from the most significant word down.
+ * @return Negative, zero or positive when a is less, equal or greater than b.
+ */
+inline int compare(const word_type *a, const word_type *b, std::size_t count) {
+  for (std::size_t i = count; i-- > 0;)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @brief Numeric words of a dynamic_bitset, whose last index is the least
+ * significant bit.
+ * @param set Bitset to pack.
+ * @param words Amount of words, at least words_for(set.size()).
+ * @return Little endian words.
+ */
+template <std::size_t N>
+bit_word::word_vector to_words(const dynamic_bitset<N> &set,
+                               std::size_t words) {
+  bit_word::word_vector result(words, 0);
+  const std::vector<bool> &bits = set.get();
+  const std::size_t size = bits.size();
+  for (std::size_t k = 0; k < size; ++k)
+    if (bits[size - 1 - k])
+      result[k / bit_word::bits] |= word_type(1) << (k % bit_word::bits);
+  return result;
+}
+
+/**
+ * @brief dynamic_bitset of size bits holding the low bits of a number.
+ * @param words Little endian words.
+ * @param size Amount of bits of the result.
+ * @return return new dynamic_bitset
+ */
+template <std::size_t N>
+dynamic_bitset<N> from_words(const bit_word::word_vector &words,
+                             std::size_t size) {
+  std::vector<bool> bits(size);
+  for (std::size_t k = 0; k < size; ++k)
+    bits[size - 1 - k] =
+        (words[k / bit_word::bits] >> (k % bit_word::bits)) & 1;
+  return dynamic_bitset<N>(std::move(bits));
+}
+} // namespace bit_arithmetic
+
+/**
+ * @brief Sum of two bitsets read as unsigned numbers, index 0 being the most
+ * significant bit like to_ulong().
+ *
+ * @return return new dynamic_bitset of the larger size, the carry out of the
+ * top bit is dropped.
+ */
+template <std::size_t N>
+dynamic_bitset<N> operator+(const dynamic_bitset<N> &a,
+                            const dynamic_bitset<N> &b) {
+  const std::size_t size = std::max(a.size(), b.size());
+  const std::size_t words = bit_word::words_for(size);
+  bit_word::word_vector x = bit_arithmetic::to_words(a, words);
+  const bit_word::word_vector y = bit_arithmetic::to_words(b, words);
+  bit_arithmetic::add_with_carry(x.data(), x.data(), y.data(), words);
+  return bit_arithmetic::from_words<N>(x, size);
+}
+
+/**
+ * @brief Difference of two bitsets read as unsigned numbers.
+ * @return return new dynamic_bitset of the larger size, wrapping modulo
+ * 2^size when b is greater than a.
+ */
+template <std::size_t N>
+dynamic_bitset<N> operator-(const dynamic_bitset<N> &a,
+                            const dynamic_bitset<N> &b) {
+  const std::size_t size = std::max(a.size(), b.size());
+  const std::size_t words = bit_word::words_for(size);
+  bit_word::word_vector x = bit_arithmetic::to_words(a, words);
+  const bit_word::word_vector y = bit_arithmetic::to_words(b, words);
+  bit_arithmetic::sub_with_borrow(x.data(), x.data(), y.data(), words);
+  return bit_arithmetic::from_words<N>(x, size);
+}
+
+/**
+ * @brief Add another bitset, see operator+.
+ * @return dynamic_bitset itself
+ */
+template <std::size_t N>
+dynamic_bitset<N> &operator+=(dynamic_bitset<N> &a,
+                              const dynamic_bitset<N> &b) {
+  a = a + b;
+  return a;
+}
+
+/**
+ * @brief Subtract another bitset, see operator-.
+ * @return dynamic_bitset itself
+ */
+template <std::size_t N>
+dynamic_bitset<N> &operator-=(dynamic_bitset<N> &a,
+                              const dynamic_bitset<N> &b) {
+  a = a - b;
+  return a;
+}
+
+/**
+ * @brief Add one modulo 2^size, only touching the trailing ones and the zero
+ * above them.
+ * @return dynamic_bitset itself
+ */
+template <std::size_t N>
+dynamic_bitset<N> &increment_numeric(dynamic_bitset<N> &set) {
+  for (std::size_t i = set.size(); i-- > 0;) {
+    if (!set[i]) {
+      set[i] = true;
+      break;
+    }
+    set[i] = false;
+  }
+  return set;
+}
+
+/**
+ * @brief Two's complement negation modulo 2^size: every bit above the least
+ * significant set bit is flipped.
+ * @return dynamic_bitset itself
+ */
+template <std::size_t N>
+dynamic_bitset<N> &negate_numeric(dynamic_bitset<N> &set) {
+  std::size_t i = set.size();
+  while (i > 0 && !set[i - 1])
+    --i;
+  if (i > 0)
+    for (--i; i-- > 0;)
+      set[i] = !set[i];
+  return set;
+}
+
+/**
+ * @brief Unsigned comparison of two bitsets of any sizes by numeric value.
+ *
+ * The bits are compared in place from the most significant end, so the cost
+ * ends at the first differing bit and nothing is packed.
+ *
+ * @return Negative, zero or positive when a is less, equal or greater than b.
+ */
+template <std::size_t N>
+int compare_numeric(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b) {
+  const std::vector<bool> &x = a.get();
+  const std::vector<bool> &y = b.get();
+  // the leading bits of the longer set are above the other set
+  const auto x_lead = static_cast<std::ptrdiff_t>(
+      x.size() - std::min(x.size(), y.size()));
+  const auto y_lead = static_cast<std::ptrdiff_t>(
+      y.size() - std::min(x.size(), y.size()));
+  if (std::find(x.begin(), x.begin() + x_lead, true) != x.begin() + x_lead)
+    return 1;
+  if (std::find(y.begin(), y.begin() + y_lead, true) != y.begin() + y_lead)
+    return -1;
+  const auto diff =
+      std::mismatch(x.begin() + x_lead, x.end(), y.begin() + y_lead);
+  if (diff.first == x.end())
+    return 0;
+  return *diff.first ? 1 : -1;
+}
+
+template <std::size_t N>
+bool operator<(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b) {
+  return compare_numeric(a, b) < 0;
+}
+
+template <std::size_t N>
+bool operator<=(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b) {
+  return compare_numeric(a, b) <= 0;
+}
+
+template <std::size_t N>
+bool operator>(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b) {
+  return compare_numeric(a, b) > 0;
+}
+
+template <std::size_t N>
+bool operator>=(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b) {
+  return compare_numeric(a, b) >= 0;
+}
+
+#endif
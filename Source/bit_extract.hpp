@@ -0,0 +1,202 @@
+#ifndef BIT_EXTRACT_H_
+#define BIT_EXTRACT_H_
+#include <cstddef>
+#include <stdexcept>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Parallel bit extract and deposit over words.
+ *
+ * With BMI2 a word takes a single pext or pdep. On CPUs where those are
+ * microcoded and slow, AMD before Zen 3, define DYNAMIC_BITSET_PORTABLE_PDEP
+ * to use the run based loops, which cost one step per run of set mask bits.
+ */
+namespace bit_extract {
+using word_type = bit_word::word_type;
+
+/**
+ * @brief Length of the run of set bits starting at bit 0 of word.
+ */
+inline std::size_t run_length(word_type word) {
+  return ~word ? bit_word::count_trailing_zeros(~word) : bit_word::bits;
+}
+
+/**
+ * @brief Gather the bits of word selected by mask into the low bits, moving
+ * a whole run of consecutive mask bits per step.
+ */
+inline word_type extract_portable(word_type word, word_type mask) {
+  word_type result = 0;
+  std::size_t offset = 0;
+  while (mask) {
+    const std::size_t low = bit_word::count_trailing_zeros(mask);
+    const std::size_t run = run_length(mask >> low);
+    result |= ((word >> low) & bit_word::low_mask(run)) << offset;
+    offset += run;
+    if (low + run == bit_word::bits)
+      break;
+    mask &= ~word_type(0) << (low + run);
+  }
+  return result;
+}
+
+/**
+ * @brief Scatter the low bits of word to the positions of the set bits of
+ * mask, moving a whole run of consecutive mask bits per step.
+ */
+inline word_type deposit_portable(word_type word, word_type mask) {
+  word_type result = 0;
+  while (mask) {
+    const std::size_t low = bit_word::count_trailing_zeros(mask);
+    const std::size_t run = run_length(mask >> low);
+    result |= (word & bit_word::low_mask(run)) << low;
+    if (low + run == bit_word::bits)
+      break;
+    word >>= run;
+    mask &= ~word_type(0) << (low + run);
+  }
+  return result;
+}
+
+/**
+ * @brief Gather the bits of word selected by mask into the low bits, pext.
+ */
+inline word_type extract(word_type word, word_type mask) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return _pext_u64(word, mask);
+#else
+  return extract_portable(word, mask);
+#endif
+}
+
+/**
+ * @brief Scatter the low bits of word to the set bits of mask, pdep.
+ */
+inline word_type deposit(word_type word, word_type mask) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return _pdep_u64(word, mask);
+#else
+  return deposit_portable(word, mask);
+#endif
+}
+
+/**
+ * @brief Extract over count words, the results are packed back to back.
+ *
+ * Word w yields popcount(mask[w]) bits that are appended at a running bit
+ * offset, spilling into the next output word when they cross a boundary.
+ *
+ * @param out Receives the packed bits, must be zeroed and hold enough words.
+ * @return Amount of bits written.
+ */
+inline std::size_t extract_words(word_type *out, const word_type *src,
+                                 const word_type *mask, std::size_t count) {
+  std::size_t offset = 0;
+  for (std::size_t w = 0; w < count; ++w) {
+    if (!mask[w])
+      continue;
+    const word_type bits = extract(src[w], mask[w]);
+    const std::size_t shift = offset % bit_word::bits;
+    out[offset / bit_word::bits] |= bits << shift;
+    const std::size_t n = bit_word::popcount(mask[w]);
+    if (shift + n > bit_word::bits)
+      out[offset / bit_word::bits + 1] |= bits >> (bit_word::bits - shift);
+    offset += n;
+  }
+  return offset;
+}
+
+/**
+ * @brief Deposit over count words, the inverse of extract_words.
+ *
+ * Word w of out takes the next popcount(mask[w]) bits of src from a running
+ * bit offset.
+ *
+ * @param src Packed bits, src_bits of them.
+ * @return Amount of bits consumed.
+ */
+inline std::size_t deposit_words(word_type *out, const word_type *src,
+                                 std::size_t src_bits, const word_type *mask,
+                                 std::size_t count) {
+  const std::size_t src_words = bit_word::words_for(src_bits);
+  std::size_t offset = 0;
+  for (std::size_t w = 0; w < count; ++w) {
+    if (!mask[w]) {
+      out[w] = 0;
+      continue;
+    }
+    const std::size_t index = offset / bit_word::bits;
+    const std::size_t shift = offset % bit_word::bits;
+    word_type bits = src[index] >> shift;
+    if (shift && index + 1 < src_words)
+      bits |= src[index + 1] << (bit_word::bits - shift);
+    out[w] = deposit(bits, mask[w]);
+    offset += bit_word::popcount(mask[w]);
+  }
+  return offset;
+}
+} // namespace bit_extract
+
+/**
+ * @brief Gather the bits of src selected by mask into a dense bitset, bit k
+ * of the result is the bit of src at the k-th set bit of mask.
+ *
+ * @param src Source bits.
+ * @param mask Selection of the size of src.
+ * @return New word_bitset with mask.count() bits.
+ */
+inline word_bitset extract(const word_bitset &src, const word_bitset &mask) {
+  if (src.size() != mask.size())
+    throw std::invalid_argument("extract needs a mask of the source size");
+  word_bitset result(mask.count());
+  bit_extract::extract_words(result.data(), src.data(), mask.data(),
+                             mask.word_count());
+  return result;
+}
+
+/**
+ * @brief Scatter dense bits to the positions selected by mask, the inverse of
+ * extract: bit k of src goes to the k-th set bit of mask.
+ *
+ * @param src Dense bits, one per set bit of mask.
+ * @param mask Target positions.
+ * @return New word_bitset of the size of mask.
+ */
+inline word_bitset deposit(const word_bitset &src, const word_bitset &mask) {
+  if (src.size() != mask.count())
+    throw std::invalid_argument("deposit needs one source bit per mask bit");
+  word_bitset result(mask.size());
+  bit_extract::deposit_words(result.data(), src.data(), src.size(),
+                             mask.data(), mask.word_count());
+  return result;
+}
+
+/**
+ * @brief Extract on dynamic_bitsets, see extract(const word_bitset &, const
+ * word_bitset &).
+ * @return New dynamic_bitset with one bit per set bit of mask.
+ */
+template <std::size_t N, std::size_t M>
+dynamic_bitset<> extract(const dynamic_bitset<N> &src,
+                         const dynamic_bitset<M> &mask) {
+  return extract(word_bitset(src), word_bitset(mask)).to_dynamic_bitset();
+}
+
+/**
+ * @brief Deposit on dynamic_bitsets, see deposit(const word_bitset &, const
+ * word_bitset &).
+ * @return New dynamic_bitset of the size of mask.
+ */
+template <std::size_t N, std::size_t M>
+dynamic_bitset<> deposit(const dynamic_bitset<N> &src,
+                         const dynamic_bitset<M> &mask) {
+  return deposit(word_bitset(src), word_bitset(mask)).to_dynamic_bitset();
+}
+
+#endif
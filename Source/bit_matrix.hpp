@@ -0,0 +1,334 @@
+#ifndef BIT_MATRIX_H_
+#define BIT_MATRIX_H_
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "bitset_array.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief A dense matrix over GF(2), addition is xor and multiplication is and.
+ *
+ * Rows are word aligned and stored back to back in one allocation, so a row
+ * operation is a straight pass over words_per_row() words and a row can be
+ * used through the dynamic_bitset like interface of bitset_view.
+ */
+class bit_matrix {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates a zero matrix.
+   *
+   * @param rows Amount of rows.
+   * @param cols Amount of columns.
+   */
+  bit_matrix(std::size_t rows, std::size_t cols)
+      : rows_(rows), cols_(cols), stride_(bit_word::words_for(cols)),
+        words_(rows * stride_, 0) {}
+
+  /**
+   * @brief Constructor that copies rows of equal size.
+   *
+   * @param rows The rows of the matrix, index j of row i is entry (i, j).
+   */
+  template <std::size_t N>
+  explicit bit_matrix(const std::vector<dynamic_bitset<N>> &rows)
+      : bit_matrix(rows.size(), rows.empty() ? 0 : rows.front().size()) {
+    for (std::size_t i = 0; i < rows_; ++i) {
+      if (rows[i].size() != cols_)
+        throw std::invalid_argument("bit_matrix rows must have equal sizes");
+      (*this)[i].assign(word_bitset(rows[i]));
+    }
+  }
+
+  /**
+   * @brief Identity matrix.
+   * @param size Amount of rows and columns.
+   * @return return new bit_matrix
+   */
+  static bit_matrix identity(std::size_t size) {
+    bit_matrix result(size, size);
+    for (std::size_t i = 0; i < size; ++i)
+      result.set(i, i, true);
+    return result;
+  }
+
+  /**
+   * @brief Return amount of rows
+   * @return Amount of rows
+   */
+  std::size_t rows() const { return rows_; }
+
+  /**
+   * @brief Return amount of columns
+   * @return Amount of columns
+   */
+  std::size_t cols() const { return cols_; }
+
+  /**
+   * @brief Return amount of words per row
+   * @return Words per row
+   */
+  std::size_t words_per_row() const { return stride_; }
+
+  /**
+   * @brief Words of a row.
+   * @return Pointer to words_per_row() words.
+   */
+  word_type *row_data(std::size_t row) { return words_.data() + row * stride_; }
+
+  /**
+   * @brief Words of a row.
+   * @return Pointer to words_per_row() words.
+   */
+  const word_type *row_data(std::size_t row) const {
+    return words_.data() + row * stride_;
+  }
+
+  /**
+   * @brief View of a row.
+   * @return Mutable view of the row.
+   */
+  bitset_view operator[](std::size_t row) {
+    return bitset_view(row_data(row), 1, cols_);
+  }
+
+  /**
+   * @brief View of a row.
+   * @return Read only view of the row.
+   */
+  const_bitset_view operator[](std::size_t row) const {
+    return const_bitset_view(row_data(row), 1, cols_);
+  }
+
+  /**
+   * @brief Get the value of entry (row, col).
+   */
+  bool test(std::size_t row, std::size_t col) const {
+    return (row_data(row)[col / bit_word::bits] >> (col % bit_word::bits)) & 1;
+  }
+
+  /**
+   * @brief Set the value of entry (row, col).
+   * @return Return object itself
+   */
+  bit_matrix &set(std::size_t row, std::size_t col, bool value) {
+    const word_type mask = word_type(1) << (col % bit_word::bits);
+    word_type &word = row_data(row)[col / bit_word::bits];
+    word = value ? word | mask : word & ~mask;
+    return *this;
+  }
+
+  /**
+   * @brief Add row src to row dst, dst ^= src.
+   * @return Return object itself
+   */
+  bit_matrix &xor_row(std::size_t dst, std::size_t src) {
+    xor_words(row_data(dst), row_data(src), 0);
+    return *this;
+  }
+
+  /**
+   * @brief Exchange two rows.
+   * @return Return object itself
+   */
+  bit_matrix &swap_rows(std::size_t a, std::size_t b) {
+    if (a != b)
+      std::swap_ranges(row_data(a), row_data(a) + stride_, row_data(b));
+    return *this;
+  }
+
+  /**
+   * @brief Bring the matrix into reduced row echelon form in place by Gaussian
+   * elimination.
+   *
+   * The pivot row of a column has no bits left of the pivot, so eliminating
+   * it from another row only touches the words from the pivot word on.
+   *
+   * @return Rank of the matrix.
+   */
+  std::size_t eliminate() { return eliminate(cols_); }
+
+  /**
+   * @brief Rank of the matrix over GF(2).
+   * @return Amount of linearly independent rows.
+   */
+  std::size_t rank() const {
+    bit_matrix copy(*this);
+    return copy.eliminate();
+  }
+
+  /**
+   * @brief Solve A x = b.
+   *
+   * @param b Right hand side with rows() bits.
+   * @param x Receives a solution with cols() bits, free variables are zero.
+   * @return False if the system has no solution.
+   */
+  bool solve(const word_bitset &b, word_bitset &x) const {
+    if (b.size() != rows_)
+      throw std::invalid_argument("bit_matrix right hand side size mismatch");
+    // eliminate the augmented matrix [A | b] on the columns of A only
+    bit_matrix augmented(rows_, cols_ + 1);
+    for (std::size_t i = 0; i < rows_; ++i) {
+      std::copy(row_data(i), row_data(i) + stride_, augmented.row_data(i));
+      augmented.set(i, cols_, b.test(i));
+    }
+    const std::size_t rank = augmented.eliminate(cols_);
+    for (std::size_t i = rank; i < rows_; ++i)
+      if (augmented.test(i, cols_))
+        return false;
+    x = word_bitset(cols_);
+    for (std::size_t i = 0; i < rank; ++i) {
+      // the pivot is the first set bit of a row in reduced echelon form
+      const word_type *row = augmented.row_data(i);
+      std::size_t w = 0;
+      while (!row[w])
+        ++w;
+      x.set(w * bit_word::bits + bit_word::count_trailing_zeros(row[w]),
+            augmented.test(i, cols_));
+    }
+    return true;
+  }
+
+  /**
+   * @brief Solve A x = b, see solve(const word_bitset &, word_bitset &).
+   * @return False if the system has no solution.
+   */
+  template <std::size_t N>
+  bool solve(const dynamic_bitset<N> &b, dynamic_bitset<> &x) const {
+    word_bitset solution;
+    if (!solve(word_bitset(b), solution))
+      return false;
+    x = solution.to_dynamic_bitset();
+    return true;
+  }
+
+  /**
+   * @brief Matrix vector product A x.
+   * @param x Vector with cols() bits.
+   * @return New word_bitset with rows() bits, bit i is the parity of
+   * row i & x.
+   */
+  word_bitset multiply(const word_bitset &x) const {
+    if (x.size() != cols_)
+      throw std::invalid_argument("bit_matrix vector size mismatch");
+    word_bitset result(rows_);
+    for (std::size_t i = 0; i < rows_; ++i) {
+      word_type parity = 0;
+      for (std::size_t w = 0; w < stride_; ++w)
+        parity ^= row_data(i)[w] & x.data()[w];
+      result.set(i, bit_word::popcount(parity) & 1);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Matrix product by the Method of Four Russians.
+   *
+   * The rows of other are taken 8 at a time and all 256 sums of them are
+   * tabulated with one row xor each, so every row of this matrix adds a whole
+   * 8 bit chunk with a single table row. The columns of the product are
+   * processed in blocks whose table fits in the L1 cache.
+   *
+   * @return return new bit_matrix of rows() x other.cols()
+   */
+  bit_matrix operator*(const bit_matrix &other) const {
+    if (cols_ != other.rows_)
+      throw std::invalid_argument("bit_matrix shapes do not match");
+    bit_matrix result(rows_, other.cols_);
+    // 256 table rows of 16 words fill 32 KiB
+    const std::size_t chunk_bits = 8;
+    const std::size_t column_block = 16;
+    const std::size_t table_rows = std::size_t(1) << chunk_bits;
+    std::vector<word_type> table(table_rows * column_block);
+    for (std::size_t first_word = 0; first_word < other.stride_;
+         first_word += column_block) {
+      const std::size_t width =
+          std::min<std::size_t>(column_block, other.stride_ - first_word);
+      for (std::size_t k = 0; k < cols_; k += chunk_bits) {
+        const std::size_t bits =
+            std::min<std::size_t>(chunk_bits, cols_ - k);
+        // table[index] is the xor of the rows k + j of other with bit j set
+        std::fill(table.begin(), table.begin() + width, 0);
+        for (std::size_t index = 1; index < (std::size_t(1) << bits);
+             ++index) {
+          const word_type *previous = &table[(index & (index - 1)) * width];
+          const word_type *row =
+              other.row_data(k + bit_word::count_trailing_zeros(index)) +
+              first_word;
+          word_type *entry = &table[index * width];
+          for (std::size_t w = 0; w < width; ++w)
+            entry[w] = previous[w] ^ row[w];
+        }
+        for (std::size_t i = 0; i < rows_; ++i) {
+          const std::size_t index =
+              (row_data(i)[k / bit_word::bits] >> (k % bit_word::bits)) &
+              (table_rows - 1);
+          if (index == 0)
+            continue;
+          const word_type *entry = &table[index * width];
+          word_type *out = result.row_data(i) + first_word;
+          for (std::size_t w = 0; w < width; ++w)
+            out[w] ^= entry[w];
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Equality operator, compares shape and every entry.
+   */
+  bool operator==(const bit_matrix &other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ &&
+           words_ == other.words_;
+  }
+
+  /**
+   * @brief Inequality operator.
+   */
+  bool operator!=(const bit_matrix &other) const { return !(*this == other); }
+
+private:
+  void xor_words(word_type *dst, const word_type *src, std::size_t from) {
+    for (std::size_t w = from; w < stride_; ++w)
+      dst[w] ^= src[w];
+  }
+
+  /**
+   * @brief Reduced row echelon form using pivots from the first pivot_cols
+   * columns only.
+   * @return Amount of pivots.
+   */
+  std::size_t eliminate(std::size_t pivot_cols) {
+    std::size_t rank = 0;
+    for (std::size_t col = 0; col < pivot_cols && rank < rows_; ++col) {
+      const std::size_t w = col / bit_word::bits;
+      const word_type mask = word_type(1) << (col % bit_word::bits);
+      std::size_t pivot = rank;
+      while (pivot < rows_ && !(row_data(pivot)[w] & mask))
+        ++pivot;
+      if (pivot == rows_)
+        continue;
+      swap_rows(rank, pivot);
+      const word_type *pivot_row = row_data(rank);
+      for (std::size_t i = 0; i < rows_; ++i)
+        if (i != rank && (row_data(i)[w] & mask))
+          xor_words(row_data(i), pivot_row, w);
+      ++rank;
+    }
+    return rank;
+  }
+
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t stride_;
+  bit_word::word_vector words_;
+};
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef BIT_SLICED_INDEX_H_
+#define BIT_SLICED_INDEX_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Comparison evaluated by bit_sliced_index::compare.
+ */
+enum class compare_op {
+  less,
+  less_equal,
+  equal,
+  not_equal,
+  greater,
+  greater_equal
+};
+
+/**
+ * @brief A column of unsigned values stored vertically, one bitmap per bit.
+ *
+ * Slice i holds bit i of every value, so aggregates and comparisons run over
+ * whole slices with word operations and popcounts instead of decoding the
+ * values row by row:
+ *  - sum() weights the popcount of every slice by 2^i,
+ *  - compare() is the O'Neil comparison against a constant,
+ *  - topk() is the O'Neil-Kaser walk from the most significant slice.
+ *
+ * Bit i of every result and filter refers to row i of the column.
+ *
+ * @tparam T Unsigned integral type of the values.
+ */
+template <typename T = std::uint64_t> class bit_sliced_index {
+  static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                "bit_sliced_index requires an unsigned integral value type");
+
+public:
+  using value_type = T;
+
+  /**
+   * @brief Default constructor that creates an empty column.
+   */
+  bit_sliced_index() : rows_(0) {}
+
+  /**
+   * @brief Constructor that adopts slices computed elsewhere.
+   *
+   * @param rows Amount of rows.
+   * @param slices Slice i holds bit i of every value, each of size rows.
+   */
+  bit_sliced_index(std::size_t rows, std::vector<word_bitset> slices)
+      : rows_(rows), slices_(std::move(slices)) {}
+
+  /**
+   * @brief Constructor that slices a column of values.
+   *
+   * @param values The column values, row i is values[i].
+   */
+  explicit bit_sliced_index(const std::vector<T> &values)
+      : rows_(values.size()) {
+    T all_bits = 0;
+    for (const auto value : values)
+      all_bits |= value;
+    std::size_t slices = 0;
+    while (slices < bits && (all_bits >> slices) != 0)
+      ++slices;
+
+    slices_.assign(slices, word_bitset(rows_));
+    for (std::size_t i = 0; i < slices; ++i) {
+      auto *words = slices_[i].data();
+      for (std::size_t row = 0; row < rows_; ++row)
+        words[row / bit_word::bits] |= static_cast<bit_word::word_type>(
+                                           (values[row] >> i) & 1)
+                                       << (row % bit_word::bits);
+    }
+  }
+
+  /**
+   * @brief Return amount of rows
+   * @return Amount of rows
+   */
+  std::size_t size() const { return rows_; }
+
+  /**
+   * @brief Return amount of slices
+   * @return Bit width of the largest value
+   */
+  std::size_t slice_count() const { return slices_.size(); }
+
+  /**
+   * @brief Rows that have bit i set.
+   * @param i Slice index, 0 is the least significant bit.
+   * @return Packed bits of the slice.
+   */
+  const word_bitset &slice(std::size_t i) const { return slices_[i]; }
+
+  /**
+   * @brief Decode the value of a single row.
+   * @param row Row index.
+   * @return The value stored in the row.
+   */
+  T value(std::size_t row) const {
+    T result = 0;
+    for (std::size_t i = 0; i < slices_.size(); ++i)
+      if (slices_[i].test(row))
+        result |= T(1) << i;
+    return result;
+  }
+
+  /**
+   * @brief Sum of every value.
+   * @return Sum, wraps around on overflow of std::uint64_t.
+   */
+  std::uint64_t sum() const {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < slices_.size(); ++i)
+      total += static_cast<std::uint64_t>(slices_[i].count()) << i;
+    return total;
+  }
+
+  /**
+   * @brief Sum of the values in the rows selected by filter.
+   * @param filter Selected rows.
+   * @return Sum, wraps around on overflow of std::uint64_t.
+   */
+  std::uint64_t sum(const word_bitset &filter) const {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < slices_.size(); ++i)
+      total += static_cast<std::uint64_t>(slices_[i].and_count(filter)) << i;
+    return total;
+  }
+
+  /**
+   * @brief Sum of the values in the rows selected by filter.
+   * @param filter Selected rows.
+   * @return Sum, wraps around on overflow of std::uint64_t.
+   */
+  template <std::size_t N>
+  std::uint64_t sum(const dynamic_bitset<N> &filter) const {
+    return sum(word_bitset(filter));
+  }
+
+  /**
+   * @brief Rows whose value satisfies value op constant.
+   * @param op The comparison.
+   * @param constant Right hand side of the comparison.
+   * @return Packed bits of the matching rows.
+   */
+  word_bitset compare(compare_op op, T constant) const {
+    word_bitset below(rows_);
+    word_bitset same(rows_, true);
+    if (slices_.size() < bits && (constant >> slices_.size()) != 0) {
+      // constant is wider than every stored value
+      below.set(true);
+      same.reset();
+    } else {
+      for (std::size_t i = slices_.size(); i-- > 0;) {
+        if ((constant >> i) & 1) {
+          below.or_and_not(same, slices_[i]);
+          same &= slices_[i];
+        } else {
+          same.and_not(slices_[i]);
+        }
+      }
+    }
+
+    switch (op) {
+    case compare_op::less:
+      return below;
+    case compare_op::less_equal:
+      return below |= same;
+    case compare_op::equal:
+      return same;
+    case compare_op::not_equal:
+      return same.flip();
+    case compare_op::greater:
+      return (below |= same).flip();
+    case compare_op::greater_equal:
+    default:
+      return below.flip();
+    }
+  }
+
+  /**
+   * @brief Rows where value == constant
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> equal(T constant) const {
+    return compare(compare_op::equal, constant).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where value < constant
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> less(T constant) const {
+    return compare(compare_op::less, constant).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where value <= constant
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> less_equal(T constant) const {
+    return compare(compare_op::less_equal, constant).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where value > constant
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> greater(T constant) const {
+    return compare(compare_op::greater, constant).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where value >= constant
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> greater_equal(T constant) const {
+    return compare(compare_op::greater_equal, constant).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows with the k largest values among the rows of filter.
+   *
+   * Ties on the k-th value are broken in favour of lower row indexes. If the
+   * filter has fewer than k rows, all of them are returned.
+   *
+   * @param k Amount of rows to select.
+   * @param filter Candidate rows.
+   * @return Packed bits of the selected rows.
+   */
+  word_bitset topk(std::size_t k, const word_bitset &filter) const {
+    word_bitset selected(rows_);
+    word_bitset ties = filter;
+    ties.resize(rows_);
+    if (k == 0)
+      return selected;
+
+    word_bitset candidate(rows_);
+    for (std::size_t i = slices_.size(); i-- > 0;) {
+      candidate = selected;
+      candidate.or_and(ties, slices_[i]);
+      const std::size_t found = candidate.count();
+      if (found > k) {
+        ties &= slices_[i];
+      } else if (found < k) {
+        selected = candidate;
+        ties.and_not(slices_[i]);
+      } else {
+        ties &= slices_[i];
+        break;
+      }
+    }
+
+    // ties now holds the rows tied on the k-th value, keep the first ones
+    std::size_t remaining = k - std::min(k, selected.count());
+    for (std::size_t row = ties.find_first();
+         remaining && row != bit_word::npos; row = ties.find_next(row)) {
+      selected.set(row, true);
+      --remaining;
+    }
+    return selected;
+  }
+
+  /**
+   * @brief Rows with the k largest values.
+   * @param k Amount of rows to select.
+   * @return dynamic_bitset of the selected rows.
+   */
+  dynamic_bitset<> topk(std::size_t k) const {
+    return topk(k, word_bitset(rows_, true)).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows with the k largest values among the rows of filter.
+   * @param k Amount of rows to select.
+   * @param filter Candidate rows.
+   * @return dynamic_bitset of the selected rows.
+   */
+  template <std::size_t N>
+  dynamic_bitset<> topk(std::size_t k, const dynamic_bitset<N> &filter) const {
+    return topk(k, word_bitset(filter)).to_dynamic_bitset();
+  }
+
+private:
+  static constexpr std::size_t bits = sizeof(T) * 8;
+
+  std::size_t rows_;
+  std::vector<word_bitset> slices_;
+};
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef BIT_TRANSPOSE_H_
+#define BIT_TRANSPOSE_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bit_matrix.hpp"
+#include "bitset_array.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Transposition kernels for square 64 x 64 bit blocks, word i holding
+ * row i with column j in bit j.
+ */
+namespace bit_transpose {
+using word_type = bit_word::word_type;
+
+/**
+ * @brief Transpose a block in place with the recursive swap-mask algorithm.
+ *
+ * Step j swaps the top right and bottom left j x j sub blocks of every
+ * 2j x 2j block at once, 32 word pairs with a mask, shift and two xors each,
+ * for j = 32, 16, ..., 1.
+ *
+ * @param block 64 words.
+ */
+inline void block64_swap(word_type *block) {
+  word_type mask = 0x00000000FFFFFFFFULL;
+  for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+    for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      const word_type t = ((block[k] >> j) ^ block[k | j]) & mask;
+      block[k] ^= t << j;
+      block[k | j] ^= t;
+    }
+  }
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+/**
+ * @brief Transpose a block in place with SSE2 movemask on 16 x 8 sub blocks.
+ *
+ * Sixteen rows are byte transposed with unpack instructions so that a
+ * register holds byte b of every row. movemask then collects the top bit of
+ * every byte, column 8b + 7, as 16 bits of an output row, and a shift by one
+ * moves the next column into the top bits.
+ *
+ * @param block 64 words.
+ */
+inline void block64_movemask(word_type *block) {
+  alignas(16) std::uint16_t result[256];
+  for (unsigned group = 0; group < 4; ++group) {
+    const word_type *rows = block + group * 16;
+    __m128i pairs[8], quads[8], octets[8];
+    for (unsigned k = 0; k < 8; ++k)
+      pairs[k] = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i *>(rows + 2 * k)),
+          _mm_loadl_epi64(
+              reinterpret_cast<const __m128i *>(rows + 2 * k + 1)));
+    for (unsigned k = 0; k < 4; ++k) {
+      quads[2 * k] = _mm_unpacklo_epi16(pairs[2 * k], pairs[2 * k + 1]);
+      quads[2 * k + 1] = _mm_unpackhi_epi16(pairs[2 * k], pairs[2 * k + 1]);
+    }
+    // octets[4 * half + i] holds bytes 2i and 2i + 1 of rows 8 * half + 0..7
+    for (unsigned half = 0; half < 2; ++half)
+      for (unsigned h = 0; h < 2; ++h) {
+        const __m128i low = quads[4 * half + h];
+        const __m128i high = quads[4 * half + 2 + h];
+        octets[4 * half + 2 * h] = _mm_unpacklo_epi32(low, high);
+        octets[4 * half + 2 * h + 1] = _mm_unpackhi_epi32(low, high);
+      }
+    for (unsigned i = 0; i < 4; ++i) {
+      // bytes 2i and 2i + 1 of all 16 rows
+      const __m128i columns[2] = {
+          _mm_unpacklo_epi64(octets[i], octets[4 + i]),
+          _mm_unpackhi_epi64(octets[i], octets[4 + i])};
+      for (unsigned c = 0; c < 2; ++c) {
+        const unsigned b = 2 * i + c;
+        __m128i x = columns[c];
+        for (unsigned bit = 8; bit-- > 0;) {
+          result[(b * 8 + bit) * 4 + group] =
+              static_cast<std::uint16_t>(_mm_movemask_epi8(x));
+          x = _mm_slli_epi64(x, 1);
+        }
+      }
+    }
+  }
+  std::memcpy(block, result, sizeof(result));
+}
+#endif
+
+/**
+ * @brief Transpose a block in place with the fastest kernel of the target,
+ * movemask when SSE2 is available.
+ * @param block 64 words.
+ */
+inline void block64(word_type *block) {
+#if defined(__SSE2__) || defined(_M_X64)
+  block64_movemask(block);
+#else
+  block64_swap(block);
+#endif
+}
+
+/**
+ * @brief Transpose a rows x cols matrix given by word accessors, tile by tile.
+ *
+ * Tiles on the right and bottom edges are padded with zeros, so any
+ * dimensions work.
+ *
+ * @param rows Amount of rows of the input.
+ * @param cols Amount of columns of the input.
+ * @param in Callable returning word w of an input row.
+ * @param out Callable storing word w of an output row.
+ */
+template <typename In, typename Out>
+void transpose(std::size_t rows, std::size_t cols, In in, Out out) {
+  word_type block[64];
+  const std::size_t row_tiles = bit_word::words_for(rows);
+  const std::size_t col_tiles = bit_word::words_for(cols);
+  for (std::size_t tile = 0; tile < row_tiles; ++tile) {
+    const std::size_t first = tile * bit_word::bits;
+    const std::size_t height =
+        rows - first < bit_word::bits ? rows - first : bit_word::bits;
+    for (std::size_t w = 0; w < col_tiles; ++w) {
+      for (std::size_t i = 0; i < height; ++i)
+        block[i] = in(first + i, w);
+      for (std::size_t i = height; i < bit_word::bits; ++i)
+        block[i] = 0;
+      block64(block);
+      const std::size_t col = w * bit_word::bits;
+      const std::size_t width =
+          cols - col < bit_word::bits ? cols - col : bit_word::bits;
+      for (std::size_t j = 0; j < width; ++j)
+        out(col + j, tile, block[j]);
+    }
+  }
+}
+} // namespace bit_transpose
+
+/**
+ * @brief Transpose of a bit matrix.
+ * @return return new bit_matrix of cols() x rows()
+ */
+inline bit_matrix transpose(const bit_matrix &matrix) {
+  bit_matrix result(matrix.cols(), matrix.rows());
+  bit_transpose::transpose(
+      matrix.rows(), matrix.cols(),
+      [&matrix](std::size_t row, std::size_t w) {
+        return matrix.row_data(row)[w];
+      },
+      [&result](std::size_t row, std::size_t w, bit_word::word_type word) {
+        result.row_data(row)[w] = word;
+      });
+  return result;
+}
+
+/**
+ * @brief Transpose of a bitset_array, bit j of row i becomes bit i of row j.
+ * @return return new bitset_array with the layout of array
+ */
+inline bitset_array transpose(const bitset_array &array) {
+  bitset_array result(array.bits(), array.rows(), array.layout());
+  bit_transpose::transpose(
+      array.rows(), array.bits(),
+      [&array](std::size_t row, std::size_t w) { return array.word(row, w); },
+      [&result](std::size_t row, std::size_t w, bit_word::word_type word) {
+        result.word(row, w) = word;
+      });
+  return result;
+}
+
+/**
+ * @brief Transpose of rows of equal size.
+ * @return New rows, index i of row j is index j of row i of the input.
+ */
+template <std::size_t N>
+std::vector<dynamic_bitset<>>
+transpose(const std::vector<dynamic_bitset<N>> &rows) {
+  const bit_matrix result = transpose(bit_matrix(rows));
+  std::vector<dynamic_bitset<>> columns;
+  columns.reserve(result.rows());
+  for (std::size_t j = 0; j < result.rows(); ++j)
+    columns.push_back(result[j].to_dynamic_bitset());
+  return columns;
+}
+
+#endif
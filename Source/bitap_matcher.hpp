@@ -0,0 +1,219 @@
+#ifndef BITAP_MATCHER_H_
+#define BITAP_MATCHER_H_
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "character_masks.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief A match returned by approximate bitap_matcher searches.
+ */
+struct bitap_match {
+  /// Index one past the last matched text character.
+  std::size_t end;
+  /// Smallest edit distance of a pattern occurrence ending at end.
+  std::size_t errors;
+
+  bool operator==(const bitap_match &other) const {
+    return end == other.end && errors == other.errors;
+  }
+};
+
+/**
+ * @brief Bit-parallel (Shift-And) matcher for patterns of any length.
+ *
+ * Bit i of the state is set when the first i + 1 pattern characters match the
+ * text ending at the current position, and every text character updates it
+ * with D = ((D << 1) | 1) & mask[c]. The state spans as many words as the
+ * pattern needs and the shift carries the top bit of every word into the
+ * next one, so a text character costs one pass over the words instead of
+ * the allocating operator<<= and operator&= of dynamic_bitset.
+ *
+ * Only the words that can hold set bits are updated, which for typical text
+ * keeps long patterns close to the cost of a single word.
+ *
+ * Approximate matching uses the Wu-Manber extension with one state per
+ * allowed error, counting insertions, deletions and substitutions.
+ */
+class bitap_matcher {
+public:
+  /**
+   * @brief Constructor that precomputes the character masks of a pattern.
+   * @param pattern Non empty pattern, characters are bytes.
+   */
+  explicit bitap_matcher(const std::string &pattern) : masks_(pattern) {
+    if (pattern.empty())
+      throw std::invalid_argument("bitap_matcher needs a non empty pattern");
+  }
+
+  /**
+   * @brief Return length of the pattern
+   * @return Amount of characters
+   */
+  std::size_t size() const { return masks_.size(); }
+
+  /**
+   * @brief Position of the first exact occurrence.
+   * @param text Text to search.
+   * @param from Index of the first text character to consider.
+   * @return Start index of the occurrence or bit_word::npos.
+   */
+  std::size_t find(const std::string &text, std::size_t from = 0) const {
+    std::size_t result = bit_word::npos;
+    scan_exact(text, from, [&](std::size_t end) {
+      result = end - size();
+      return false;
+    });
+    return result;
+  }
+
+  /**
+   * @brief Check if the text contains the pattern with at most errors edits.
+   * @return True if an occurrence exists.
+   */
+  bool contains(const std::string &text, std::size_t errors = 0) const {
+    if (errors == 0)
+      return find(text) != bit_word::npos;
+    bool found = false;
+    scan_approximate(text, errors, [&](std::size_t, std::size_t) {
+      found = true;
+      return false;
+    });
+    return found;
+  }
+
+  /**
+   * @brief Every exact occurrence, overlapping ones included.
+   * @param text Text to search.
+   * @return Start indexes in increasing order.
+   */
+  std::vector<std::size_t> find_all(const std::string &text) const {
+    std::vector<std::size_t> result;
+    scan_exact(text, 0, [&](std::size_t end) {
+      result.push_back(end - size());
+      return true;
+    });
+    return result;
+  }
+
+  /**
+   * @brief Every text position where an occurrence with at most errors edits
+   * ends.
+   *
+   * @param text Text to search.
+   * @param errors Largest allowed edit distance, less than size().
+   * @return Matches in increasing order of end.
+   */
+  std::vector<bitap_match> find_all(const std::string &text,
+                                    std::size_t errors) const {
+    std::vector<bitap_match> result;
+    scan_approximate(text, errors, [&](std::size_t end, std::size_t found) {
+      result.push_back({end, found});
+      return true;
+    });
+    return result;
+  }
+
+private:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Run the exact automaton, calling report(end) for every match until
+   * it returns false.
+   */
+  template <typename Report>
+  void scan_exact(const std::string &text, std::size_t from,
+                  Report report) const {
+    const std::size_t words = masks_.word_count();
+    bit_word::word_vector state(words, 0);
+    const std::size_t last = words - 1;
+    const word_type hit = masks_.last_bit();
+    std::size_t active = 1;
+    for (std::size_t j = from; j < text.size(); ++j) {
+      const word_type *m = masks_[text[j]];
+      const std::size_t limit = active < words ? active + 1 : words;
+      word_type carry = 1;
+      for (std::size_t w = 0; w < limit; ++w) {
+        const word_type old = state[w];
+        state[w] = ((old << 1) | carry) & m[w];
+        carry = old >> (bit_word::bits - 1);
+      }
+      active = limit;
+      while (active > 1 && state[active - 1] == 0)
+        --active;
+      if ((state[last] & hit) && !report(j + 1))
+        return;
+    }
+  }
+
+  /**
+   * @brief Run the Wu-Manber automaton, calling report(end, errors) for every
+   * match until it returns false.
+   */
+  template <typename Report>
+  void scan_approximate(const std::string &text, std::size_t errors,
+                        Report report) const {
+    if (errors >= size())
+      throw std::invalid_argument("bitap_matcher errors must be less than "
+                                  "the pattern length");
+    const std::size_t rows = errors + 1;
+    const std::size_t words = masks_.word_count();
+    const std::size_t last = words - 1;
+    const word_type top = masks_.top_mask();
+    const word_type hit = masks_.last_bit();
+    // row d starts with the first d pattern characters deleted
+    bit_word::word_vector state(rows * words, 0);
+    for (std::size_t d = 1; d < rows; ++d)
+      for (std::size_t i = 0; i < d; ++i)
+        state[d * words + i / bit_word::bits] |= word_type(1)
+                                                  << (i % bit_word::bits);
+    std::vector<word_type> carry_old(rows), carry_new(rows);
+    // a step moves the highest set bit up by at most rows positions
+    const std::size_t reach = 1 + errors / bit_word::bits;
+    std::size_t active = std::max<std::size_t>(bit_word::words_for(errors), 1);
+    for (std::size_t j = 0; j < text.size(); ++j) {
+      const word_type *m = masks_[text[j]];
+      const std::size_t limit = std::min(active + reach, words);
+      std::fill(carry_old.begin(), carry_old.end(), 1);
+      std::fill(carry_new.begin(), carry_new.end(), 1);
+      for (std::size_t w = 0; w < limit; ++w) {
+        word_type prev_old = 0, prev_shifted_old = 0, prev_shifted_new = 0;
+        for (std::size_t d = 0; d < rows; ++d) {
+          word_type &word = state[d * words + w];
+          const word_type old = word;
+          const word_type shifted_old = (old << 1) | carry_old[d];
+          carry_old[d] = old >> (bit_word::bits - 1);
+          word_type next = shifted_old & m[w];
+          // insertion, substitution and deletion from the row above
+          if (d)
+            next |= prev_old | prev_shifted_old | prev_shifted_new;
+          if (w == last)
+            next &= top;
+          word = next;
+          const word_type shifted_new = (next << 1) | carry_new[d];
+          carry_new[d] = next >> (bit_word::bits - 1);
+          prev_old = old;
+          prev_shifted_old = shifted_old;
+          prev_shifted_new = shifted_new;
+        }
+      }
+      active = limit;
+      while (active > 1 && state[errors * words + active - 1] == 0)
+        --active;
+      for (std::size_t d = 0; d < rows; ++d)
+        if (state[d * words + last] & hit) {
+          if (!report(j + 1, d))
+            return;
+          break;
+        }
+    }
+  }
+
+  character_masks masks_;
+};
+
+#endif
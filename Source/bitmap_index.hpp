@@ -0,0 +1,277 @@
+#ifndef BITMAP_INDEX_H_
+#define BITMAP_INDEX_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "bit_sliced_index.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Layout of the bitmaps kept by a bitmap_index.
+ */
+enum class bitmap_encoding {
+  /// One bitmap per distinct value, rows equal to the value.
+  equality,
+  /// One bitmap per distinct value, rows less than or equal to the value.
+  range,
+  /// One bitmap per bit of the value rank (bit-sliced index).
+  bit_sliced
+};
+
+/**
+ * @brief A bitmap index over a column of integer values.
+ *
+ * The index maps every distinct value of the column to its rank in sorted
+ * order and stores the rows as bitmaps in the chosen encoding. Every query is
+ * reduced to a half open rank interval and answered with bitmap operations
+ * only:
+ *  - equality encoding answers equal() with a single bitmap,
+ *  - range encoding answers any interval with one and_not,
+ *  - bit sliced encoding answers any interval with O(log cardinality)
+ *    operations while storing only log2(cardinality) bitmaps.
+ *
+ * Bit i of every result refers to row i of the indexed column.
+ *
+ * @tparam T Integral type of the column values.
+ */
+template <typename T = std::int64_t> class bitmap_index {
+  static_assert(std::is_integral<T>::value,
+                "bitmap_index requires an integral value type");
+
+public:
+  /**
+   * @brief Constructor that builds the index of a column.
+   *
+   * @param column The column values, row i is column[i].
+   * @param encoding Layout of the bitmaps.
+   */
+  explicit bitmap_index(const std::vector<T> &column,
+                        bitmap_encoding encoding = bitmap_encoding::equality)
+      : encoding_(encoding), rows_(column.size()) {
+    keys_ = column;
+    std::sort(keys_.begin(), keys_.end());
+    keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+
+    std::vector<std::size_t> ranks(rows_);
+    for (std::size_t row = 0; row < rows_; ++row)
+      ranks[row] = lower_rank(column[row]);
+
+    switch (encoding_) {
+    case bitmap_encoding::equality:
+      build_equality(ranks);
+      break;
+    case bitmap_encoding::range:
+      build_equality(ranks);
+      // prefix or turns equality bitmaps into rank <= i bitmaps, the last
+      // one would contain every row and is not stored
+      for (std::size_t i = 1; i < bitmaps_.size(); ++i)
+        bitmaps_[i] |= bitmaps_[i - 1];
+      if (!bitmaps_.empty())
+        bitmaps_.pop_back();
+      break;
+    case bitmap_encoding::bit_sliced:
+      ranks_ = bit_sliced_index<std::size_t>(ranks);
+      break;
+    }
+  }
+
+  /**
+   * @brief Return amount of indexed rows
+   * @return Amount of rows
+   */
+  std::size_t size() const { return rows_; }
+
+  /**
+   * @brief Return amount of distinct values
+   * @return Cardinality of the column
+   */
+  std::size_t cardinality() const { return keys_.size(); }
+
+  /**
+   * @brief Return encoding of the index
+   * @return bitmap_encoding of the index
+   */
+  bitmap_encoding encoding() const { return encoding_; }
+
+  /**
+   * @brief Return amount of stored bitmaps
+   * @return Amount of bitmaps
+   */
+  std::size_t bitmap_count() const {
+    return encoding_ == bitmap_encoding::bit_sliced ? ranks_.slice_count()
+                                                    : bitmaps_.size();
+  }
+
+  /**
+   * @brief Rows where column == value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> equal(T value) const {
+    return select_equal(value).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column != value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> not_equal(T value) const {
+    return select_equal(value).flip().to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column < value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> less(T value) const {
+    return select(0, lower_rank(value)).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column <= value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> less_equal(T value) const {
+    return select(0, upper_rank(value)).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column > value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> greater(T value) const {
+    return select(upper_rank(value), keys_.size()).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column >= value
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> greater_equal(T value) const {
+    return select(lower_rank(value), keys_.size()).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where low <= column <= high
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> between(T low, T high) const {
+    if (high < low)
+      return word_bitset(rows_).to_dynamic_bitset();
+    return select(lower_rank(low), upper_rank(high)).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Rows where column is one of values
+   * @return dynamic_bitset of matching rows
+   */
+  dynamic_bitset<> in(const std::vector<T> &values) const {
+    word_bitset result(rows_);
+    for (const auto &value : values)
+      result |= select_equal(value);
+    return result.to_dynamic_bitset();
+  }
+
+private:
+  /**
+   * @brief Amount of distinct values less than value.
+   */
+  std::size_t lower_rank(T value) const {
+    return std::lower_bound(keys_.begin(), keys_.end(), value) - keys_.begin();
+  }
+
+  /**
+   * @brief Amount of distinct values less than or equal to value.
+   */
+  std::size_t upper_rank(T value) const {
+    return std::upper_bound(keys_.begin(), keys_.end(), value) - keys_.begin();
+  }
+
+  /**
+   * @brief Rows equal to value as packed bits.
+   */
+  word_bitset select_equal(T value) const {
+    const std::size_t rank = lower_rank(value);
+    if (rank == keys_.size() || keys_[rank] != value)
+      return word_bitset(rows_);
+    return select(rank, rank + 1);
+  }
+
+  /**
+   * @brief Rows whose rank is in [first, last) as packed bits.
+   */
+  word_bitset select(std::size_t first, std::size_t last) const {
+    if (first >= last)
+      return word_bitset(rows_);
+    if (first == 0 && last == keys_.size())
+      return word_bitset(rows_, true);
+
+    switch (encoding_) {
+    case bitmap_encoding::equality:
+      return select_equality(first, last);
+    case bitmap_encoding::range:
+      return select_range(first, last);
+    case bitmap_encoding::bit_sliced:
+    default:
+      return select_slices(first, last);
+    }
+  }
+
+  /**
+   * @brief Or of the equality bitmaps in [first, last), or the complement of
+   * the ones outside of it when that touches fewer bitmaps.
+   */
+  word_bitset select_equality(std::size_t first, std::size_t last) const {
+    if (last - first == 1)
+      return bitmaps_[first];
+    const bool complement = (last - first) * 2 > keys_.size();
+    word_bitset result(rows_);
+    for (std::size_t i = 0; i < keys_.size(); ++i)
+      if ((i >= first && i < last) != complement)
+        result |= bitmaps_[i];
+    if (complement)
+      result.flip();
+    return result;
+  }
+
+  /**
+   * @brief rank <= last - 1 and not rank <= first - 1.
+   */
+  word_bitset select_range(std::size_t first, std::size_t last) const {
+    word_bitset result = last == keys_.size() ? word_bitset(rows_, true)
+                                              : bitmaps_[last - 1];
+    if (first > 0)
+      result.and_not(bitmaps_[first - 1]);
+    return result;
+  }
+
+  /**
+   * @brief rank < last and not rank < first over the rank slices.
+   */
+  word_bitset select_slices(std::size_t first, std::size_t last) const {
+    word_bitset result = ranks_.compare(compare_op::less, last);
+    if (first > 0)
+      result.and_not(ranks_.compare(compare_op::less, first));
+    return result;
+  }
+
+  /**
+   * @brief One bitmap per distinct value.
+   */
+  void build_equality(const std::vector<std::size_t> &ranks) {
+    bitmaps_.assign(keys_.size(), word_bitset(rows_));
+    for (std::size_t row = 0; row < rows_; ++row)
+      bitmaps_[ranks[row]].set(row, true);
+  }
+
+  bitmap_encoding encoding_;
+  std::size_t rows_;
+  std::vector<T> keys_;
+  std::vector<word_bitset> bitmaps_;
+  bit_sliced_index<std::size_t> ranks_;
+};
+
+#endif
@@ -0,0 +1,501 @@
+#ifndef BITSET_ARRAY_H_
+#define BITSET_ARRAY_H_
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Word layout of a bitset_array.
+ */
+enum class bitset_layout {
+  /// The words of a row are contiguous, row after row.
+  row_major,
+  /// Word w of every row is contiguous, word index after word index.
+  interleaved
+};
+
+/**
+ * @brief A bitset stored in words that are stride words apart.
+ *
+ * Views are handed out by bitset_array and mirror the read and write
+ * interface of dynamic_bitset. A view does not own its words and is
+ * invalidated when the array is destroyed.
+ *
+ * @tparam Word word_type for mutable views, const word_type for read only
+ * views.
+ */
+template <typename Word> class basic_bitset_view {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that views words.
+   *
+   * @param words Pointer to word 0 of the bitset.
+   * @param stride Distance between consecutive words.
+   * @param size Amount of bits.
+   */
+  basic_bitset_view(Word *words, std::size_t stride, std::size_t size)
+      : words_(words), stride_(stride), size_(size) {}
+
+  /**
+   * @brief Read only view of a mutable view.
+   */
+  template <typename Other,
+            typename = typename std::enable_if<
+                std::is_same<Word, const word_type>::value &&
+                std::is_same<Other, word_type>::value>::type>
+  basic_bitset_view(const basic_bitset_view<Other> &other)
+      : words_(other.data()), stride_(other.stride()), size_(other.size()) {}
+
+  /**
+   * @brief Return size of the bitset
+   * @return Amount of bits
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Return distance between consecutive words
+   * @return Stride in words
+   */
+  std::size_t stride() const { return stride_; }
+
+  /**
+   * @brief Return amount of words
+   * @return Amount of words
+   */
+  std::size_t word_count() const { return bit_word::words_for(size_); }
+
+  /**
+   * @brief Pointer to word 0 of the bitset.
+   * @return Pointer to the first word.
+   */
+  Word *data() const { return words_; }
+
+  /**
+   * @brief Word w of the bitset.
+   * @return Reference to the word.
+   */
+  Word &word(std::size_t w) const { return words_[w * stride_]; }
+
+  /**
+   * @brief Get the value of a bit at a given index.
+   * @param index The index of the bit.
+   * @return The value of the bit at the given index.
+   */
+  bool operator[](std::size_t index) const { return test(index); }
+
+  /**
+   * @brief Get the value of a bit at a given index.
+   * @param index The index of the bit.
+   * @return The value of the bit at the given index.
+   */
+  bool test(std::size_t index) const {
+    return (word(index / bit_word::bits) >> (index % bit_word::bits)) & 1;
+  }
+
+  /**
+   * @brief Set the value of a single bit.
+   * @return Return view itself
+   */
+  const basic_bitset_view &set(std::size_t index, bool value) const {
+    const word_type mask = word_type(1) << (index % bit_word::bits);
+    if (value)
+      word(index / bit_word::bits) |= mask;
+    else
+      word(index / bit_word::bits) &= ~mask;
+    return *this;
+  }
+
+  /**
+   * @brief Set all value of the bitset
+   * @return Return view itself
+   */
+  const basic_bitset_view &set(bool value) const {
+    const std::size_t words = word_count();
+    for (std::size_t w = 0; w < words; ++w)
+      word(w) = value ? ~word_type(0) : 0;
+    if (value && size_ % bit_word::bits)
+      word(words - 1) &= bit_word::low_mask(size_ % bit_word::bits);
+    return *this;
+  }
+
+  /**
+   * @brief Set all value to 0
+   * @return Return view itself
+   */
+  const basic_bitset_view &reset() const { return set(false); }
+
+  /**
+   * @brief Copy the bits of a word_bitset, bits past size() are dropped and
+   * bits missing from a shorter source are 0.
+   * @return Return view itself
+   */
+  const basic_bitset_view &assign(const word_bitset &bits) const {
+    const std::size_t words = word_count();
+    const std::size_t common = std::min(words, bits.word_count());
+    for (std::size_t w = 0; w < common; ++w)
+      word(w) = bits.data()[w];
+    for (std::size_t w = common; w < words; ++w)
+      word(w) = 0;
+    if (common == words && size_ % bit_word::bits)
+      word(words - 1) &= bit_word::low_mask(size_ % bit_word::bits);
+    return *this;
+  }
+
+  /**
+   * @brief Number of set bits
+   * @return Population count of the bitset
+   */
+  std::size_t count() const {
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < word_count(); ++w)
+      total += bit_word::popcount(word(w));
+    return total;
+  }
+
+  /**
+   * @brief Check if any bit is true.
+   * @return True if any bit is true, false otherwise.
+   */
+  bool any() const {
+    for (std::size_t w = 0; w < word_count(); ++w)
+      if (word(w))
+        return true;
+    return false;
+  }
+
+  /**
+   * @brief Check if none of the bits are true.
+   * @return True if none of the bits are true, false otherwise.
+   */
+  bool none() const { return !any(); }
+
+  /**
+   * @brief Check if all bits are true.
+   * @return True if all bits are true, false otherwise.
+   */
+  bool all() const { return count() == size_; }
+
+  /**
+   * @brief Copy into an owning word_bitset.
+   * @return New word_bitset with the same bits.
+   */
+  word_bitset to_word_bitset() const {
+    word_bitset result(size_);
+    for (std::size_t w = 0; w < word_count(); ++w)
+      result.data()[w] = word(w);
+    return result;
+  }
+
+  /**
+   * @brief Copy into a dynamic_bitset.
+   * @return New dynamic_bitset with the same bits.
+   */
+  dynamic_bitset<> to_dynamic_bitset() const {
+    return to_word_bitset().to_dynamic_bitset();
+  }
+
+  /**
+   * @brief convert bitset to string bitset
+   * @return Return string
+   */
+  std::string to_string() const {
+    std::string str;
+    for (std::size_t i = 0; i < size_; ++i)
+      str.push_back(test(i) ? '1' : '0');
+    return str;
+  }
+
+  /**
+   * @brief ostream operator to print the view
+   * @return ostream
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const basic_bitset_view &view) {
+    return out << view.to_string();
+  }
+
+private:
+  Word *words_;
+  std::size_t stride_;
+  std::size_t size_;
+};
+
+using bitset_view = basic_bitset_view<bit_word::word_type>;
+using const_bitset_view = basic_bitset_view<const bit_word::word_type>;
+
+/**
+ * @brief K bitsets of equal length in one contiguous allocation.
+ *
+ * Rows are accessed as views. Element wise operations between arrays of the
+ * same shape and layout are a single pass over the shared storage, and the
+ * reductions walk the words in storage order:
+ *  - row_major keeps a row within consecutive cache lines, best for per row
+ *    work,
+ *  - interleaved keeps word w of every row together, best for work across
+ *    rows such as column_counts().
+ */
+class bitset_array {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates rows cleared bitsets.
+   *
+   * @param rows Amount of bitsets.
+   * @param bits Length of every bitset.
+   * @param layout Word layout.
+   */
+  bitset_array(std::size_t rows, std::size_t bits,
+               bitset_layout layout = bitset_layout::row_major)
+      : rows_(rows), bits_(bits), words_per_row_(bit_word::words_for(bits)),
+        layout_(layout), words_(rows * words_per_row_, 0) {}
+
+  /**
+   * @brief Return amount of bitsets
+   * @return Amount of rows
+   */
+  std::size_t rows() const { return rows_; }
+
+  /**
+   * @brief Return length of every bitset
+   * @return Amount of bits per row
+   */
+  std::size_t bits() const { return bits_; }
+
+  /**
+   * @brief Return word layout
+   * @return bitset_layout of the array
+   */
+  bitset_layout layout() const { return layout_; }
+
+  /**
+   * @brief Return amount of words per row
+   * @return Words per row
+   */
+  std::size_t words_per_row() const { return words_per_row_; }
+
+  /**
+   * @brief Access the underlying words.
+   * @return Pointer to the first word.
+   */
+  const word_type *data() const { return words_.data(); }
+
+  /**
+   * @brief Word w of a row.
+   * @return Reference to the word.
+   */
+  word_type &word(std::size_t row, std::size_t w) {
+    return words_[offset(row, w)];
+  }
+
+  /**
+   * @brief Word w of a row.
+   * @return The word.
+   */
+  word_type word(std::size_t row, std::size_t w) const {
+    return words_[offset(row, w)];
+  }
+
+  /**
+   * @brief View of a row.
+   * @return Mutable view of the row.
+   */
+  bitset_view operator[](std::size_t row) {
+    return bitset_view(words_.data() + offset(row, 0), stride(), bits_);
+  }
+
+  /**
+   * @brief View of a row.
+   * @return Read only view of the row.
+   */
+  const_bitset_view operator[](std::size_t row) const {
+    return const_bitset_view(words_.data() + offset(row, 0), stride(), bits_);
+  }
+
+  /**
+   * @brief Element wise and, row i with row i of other.
+   * @return bitset_array itself
+   */
+  bitset_array &operator&=(const bitset_array &other) {
+    check_shape(other);
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      words_[i] &= other.words_[i];
+    return *this;
+  }
+
+  /**
+   * @brief Element wise or, row i with row i of other.
+   * @return bitset_array itself
+   */
+  bitset_array &operator|=(const bitset_array &other) {
+    check_shape(other);
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      words_[i] |= other.words_[i];
+    return *this;
+  }
+
+  /**
+   * @brief Element wise xor, row i with row i of other.
+   * @return bitset_array itself
+   */
+  bitset_array &operator^=(const bitset_array &other) {
+    check_shape(other);
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      words_[i] ^= other.words_[i];
+    return *this;
+  }
+
+  /**
+   * @brief Element wise this &= ~other.
+   * @return bitset_array itself
+   */
+  bitset_array &and_not(const bitset_array &other) {
+    check_shape(other);
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      words_[i] &= ~other.words_[i];
+    return *this;
+  }
+
+  /**
+   * @brief and operator between two bitset_array
+   * @return return new bitset_array
+   */
+  bitset_array operator&(const bitset_array &other) const {
+    bitset_array result(*this);
+    result &= other;
+    return result;
+  }
+
+  /**
+   * @brief or operator between two bitset_array
+   * @return return new bitset_array
+   */
+  bitset_array operator|(const bitset_array &other) const {
+    bitset_array result(*this);
+    result |= other;
+    return result;
+  }
+
+  /**
+   * @brief xor operator between two bitset_array
+   * @return return new bitset_array
+   */
+  bitset_array operator^(const bitset_array &other) const {
+    bitset_array result(*this);
+    result ^= other;
+    return result;
+  }
+
+  /**
+   * @brief Population count of every row.
+   * @return Count of row i at index i.
+   */
+  std::vector<std::size_t> row_counts() const {
+    std::vector<std::size_t> counts(rows_, 0);
+    for_each_word([&counts](std::size_t row, std::size_t, word_type word) {
+      counts[row] += bit_word::popcount(word);
+    });
+    return counts;
+  }
+
+  /**
+   * @brief Rows that have at least one bit set.
+   * @return Bit i is set if row i is not empty.
+   */
+  word_bitset row_any() const {
+    word_bitset result(rows_);
+    for_each_word([&result](std::size_t row, std::size_t, word_type word) {
+      if (word)
+        result.set(row, true);
+    });
+    return result;
+  }
+
+  /**
+   * @brief Amount of rows that have each bit set.
+   * @return Count of bit position i at index i.
+   */
+  std::vector<std::size_t> column_counts() const {
+    std::vector<std::size_t> counts(bits_, 0);
+    for_each_word([&counts](std::size_t, std::size_t w, word_type word) {
+      while (word) {
+        ++counts[w * bit_word::bits + bit_word::count_trailing_zeros(word)];
+        word &= word - 1;
+      }
+    });
+    return counts;
+  }
+
+  /**
+   * @brief Or of every row.
+   * @return Bit i is set if any row has bit i set.
+   */
+  word_bitset column_or() const {
+    word_bitset result(bits_);
+    for_each_word([&result](std::size_t, std::size_t w, word_type word) {
+      result.data()[w] |= word;
+    });
+    return result;
+  }
+
+  /**
+   * @brief And of every row.
+   * @return Bit i is set if every row has bit i set.
+   */
+  word_bitset column_and() const {
+    word_bitset result(bits_, true);
+    for_each_word([&result](std::size_t, std::size_t w, word_type word) {
+      result.data()[w] &= word;
+    });
+    return result;
+  }
+
+private:
+  std::size_t stride() const {
+    return layout_ == bitset_layout::row_major ? 1 : rows_;
+  }
+
+  std::size_t offset(std::size_t row, std::size_t w) const {
+    return layout_ == bitset_layout::row_major ? row * words_per_row_ + w
+                                               : w * rows_ + row;
+  }
+
+  /**
+   * @brief Call function(row, w, word) for every word in storage order.
+   */
+  template <typename Function> void for_each_word(Function function) const {
+    std::size_t i = 0;
+    if (layout_ == bitset_layout::row_major) {
+      for (std::size_t row = 0; row < rows_; ++row)
+        for (std::size_t w = 0; w < words_per_row_; ++w)
+          function(row, w, words_[i++]);
+    } else {
+      for (std::size_t w = 0; w < words_per_row_; ++w)
+        for (std::size_t row = 0; row < rows_; ++row)
+          function(row, w, words_[i++]);
+    }
+  }
+
+  void check_shape(const bitset_array &other) const {
+    if (rows_ != other.rows_ || bits_ != other.bits_ ||
+        layout_ != other.layout_)
+      throw std::invalid_argument("bitset_array shapes do not match");
+  }
+
+  std::size_t rows_;
+  std::size_t bits_;
+  std::size_t words_per_row_;
+  bitset_layout layout_;
+  bit_word::word_vector words_;
+};
+
+#endif
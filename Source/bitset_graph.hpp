@@ -0,0 +1,260 @@
+#ifndef BITSET_GRAPH_H_
+#define BITSET_GRAPH_H_
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bit_matrix.hpp"
+#include "bit_transpose.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief A graph stored as an adjacency bit matrix, one row per vertex.
+ *
+ * Bit v of row u is set when the edge u -> v exists; undirected graphs keep
+ * the matrix symmetric. The algorithms work on whole rows of 64 vertices per
+ * word, which beats adjacency lists on dense graphs:
+ *  - bfs() switches between top-down steps, or-ing the rows of the frontier
+ *    into the next frontier, and bottom-up steps, where every unvisited
+ *    vertex checks its row against the frontier and stops at the first hit,
+ *  - triangle_count() intersects the rows of the endpoints of every edge,
+ *  - transitive_closure() is Warshall's algorithm with row ors.
+ */
+class bitset_graph {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates a graph without edges.
+   *
+   * @param vertices Amount of vertices.
+   * @param directed False to keep every edge in both directions.
+   */
+  explicit bitset_graph(std::size_t vertices, bool directed = false)
+      : adjacency_(vertices, vertices), directed_(directed),
+        degrees_(vertices, 0),
+        incoming_(directed ? vertices : 0, directed ? vertices : 0) {}
+
+  /**
+   * @brief Return amount of vertices
+   * @return Amount of vertices
+   */
+  std::size_t size() const { return adjacency_.rows(); }
+
+  /**
+   * @brief Check if the graph is directed.
+   * @return True for directed graphs.
+   */
+  bool directed() const { return directed_; }
+
+  /**
+   * @brief Access the adjacency matrix.
+   * @return Matrix with bit v of row u set for an edge u -> v.
+   */
+  const bit_matrix &adjacency() const { return adjacency_; }
+
+  /**
+   * @brief Out neighbours of a vertex.
+   * @return Read only view of the adjacency row.
+   */
+  const_bitset_view neighbors(std::size_t u) const { return adjacency_[u]; }
+
+  /**
+   * @brief Amount of out neighbours of a vertex.
+   */
+  std::size_t degree(std::size_t u) const { return degrees_[u]; }
+
+  /**
+   * @brief Amount of edges, an undirected edge counts once.
+   */
+  std::size_t edge_count() const {
+    std::size_t total = 0, loops = 0;
+    for (std::size_t u = 0; u < size(); ++u) {
+      total += degrees_[u];
+      loops += adjacency_.test(u, u);
+    }
+    return directed_ ? total : (total + loops) / 2;
+  }
+
+  /**
+   * @brief Check if the edge u -> v exists.
+   */
+  bool has_edge(std::size_t u, std::size_t v) const {
+    return adjacency_.test(u, v);
+  }
+
+  /**
+   * @brief Add the edge u -> v, and v -> u for undirected graphs.
+   * @return Return object itself
+   */
+  bitset_graph &add_edge(std::size_t u, std::size_t v) {
+    set_edge(u, v, true);
+    if (!directed_)
+      set_edge(v, u, true);
+    return *this;
+  }
+
+  /**
+   * @brief Remove the edge u -> v, and v -> u for undirected graphs.
+   * @return Return object itself
+   */
+  bitset_graph &remove_edge(std::size_t u, std::size_t v) {
+    set_edge(u, v, false);
+    if (!directed_)
+      set_edge(v, u, false);
+    return *this;
+  }
+
+  /**
+   * @brief Direction optimizing breadth first search.
+   *
+   * A step runs bottom-up when the edges leaving the frontier exceed 1/14 of
+   * the edges of the unvisited vertices, and top-down again once the
+   * frontier holds less than 1/24 of the vertices. Bottom-up steps on a
+   * directed graph use the transposed matrix, which is kept up to date by
+   * every edge change, so concurrent searches on a const graph are safe.
+   *
+   * @param source Start vertex.
+   * @return Hop distance of every vertex, bit_word::npos if unreachable.
+   */
+  std::vector<std::size_t> bfs(std::size_t source) const {
+    const std::size_t n = size();
+    const std::size_t words = adjacency_.words_per_row();
+    std::vector<std::size_t> distance(n, bit_word::npos);
+    word_bitset frontier(n), next(n), unvisited(n, true);
+    frontier.set(source, true);
+    unvisited.reset(source);
+    distance[source] = 0;
+    std::size_t frontier_size = 1;
+    std::size_t frontier_edges = degrees_[source];
+    std::size_t unvisited_edges = 0;
+    for (std::size_t u = 0; u < n; ++u)
+      unvisited_edges += degrees_[u];
+    unvisited_edges -= frontier_edges;
+    bool bottom_up = false;
+    for (std::size_t level = 1; frontier_size > 0; ++level) {
+      if (!bottom_up && frontier_edges * 14 > unvisited_edges)
+        bottom_up = true;
+      else if (bottom_up && frontier_size * 24 < n)
+        bottom_up = false;
+      next.reset();
+      word_type *out = next.data();
+      const word_type *open = unvisited.data();
+      if (bottom_up) {
+        const bit_matrix &incoming = directed_ ? incoming_ : adjacency_;
+        const word_type *current = frontier.data();
+        unvisited.for_each([&](std::size_t v) {
+          const word_type *row = incoming.row_data(v);
+          for (std::size_t w = 0; w < words; ++w)
+            if (row[w] & current[w]) {
+              out[v / bit_word::bits] |= word_type(1) << (v % bit_word::bits);
+              break;
+            }
+        });
+      } else {
+        frontier.for_each([&](std::size_t u) {
+          const word_type *row = adjacency_.row_data(u);
+          for (std::size_t w = 0; w < words; ++w)
+            out[w] |= row[w] & open[w];
+        });
+      }
+      unvisited.and_not(next);
+      frontier_size = 0;
+      frontier_edges = 0;
+      next.for_each([&](std::size_t v) {
+        distance[v] = level;
+        ++frontier_size;
+        frontier_edges += degrees_[v];
+      });
+      unvisited_edges -= frontier_edges;
+      std::swap(frontier, next);
+    }
+    return distance;
+  }
+
+  /**
+   * @brief Amount of triangles of an undirected graph.
+   *
+   * Every triangle u < v < w is counted once, at its edge (u, v), as a common
+   * neighbour above v, so only the words from v on are intersected.
+   *
+   * @return Amount of triangles, self loops are ignored.
+   */
+  std::size_t triangle_count() const {
+    if (directed_)
+      throw std::invalid_argument("triangle_count needs an undirected graph");
+    const std::size_t words = adjacency_.words_per_row();
+    std::size_t total = 0;
+    for (std::size_t u = 0; u < size(); ++u) {
+      const word_type *row_u = adjacency_.row_data(u);
+      for (std::size_t v = u + 1; v < size(); ++v) {
+        if (!((row_u[v / bit_word::bits] >> (v % bit_word::bits)) & 1))
+          continue;
+        const word_type *row_v = adjacency_.row_data(v);
+        const std::size_t first = (v + 1) / bit_word::bits;
+        if (first >= words)
+          continue;
+        total += bit_word::popcount(
+            row_u[first] & row_v[first] &
+            ~bit_word::low_mask((v + 1) % bit_word::bits));
+        for (std::size_t w = first + 1; w < words; ++w)
+          total += bit_word::popcount(row_u[w] & row_v[w]);
+      }
+    }
+    return total;
+  }
+
+  /**
+   * @brief Reachability graph, Warshall's algorithm with row ors: once the
+   * rows know every path through vertices below k, a row that reaches k
+   * takes over the row of k.
+   *
+   * @return return new directed bitset_graph with the edge u -> v when v is
+   * reachable from u by a path of at least one edge.
+   */
+  bitset_graph transitive_closure() const {
+    bitset_graph result(size(), true);
+    result.adjacency_ = adjacency_;
+    bit_matrix &reach = result.adjacency_;
+    const std::size_t words = reach.words_per_row();
+    for (std::size_t k = 0; k < size(); ++k) {
+      const word_type *row_k = reach.row_data(k);
+      const std::size_t w_k = k / bit_word::bits;
+      const word_type bit_k = word_type(1) << (k % bit_word::bits);
+      for (std::size_t i = 0; i < size(); ++i) {
+        if (i == k || !(reach.row_data(i)[w_k] & bit_k))
+          continue;
+        word_type *row_i = reach.row_data(i);
+        for (std::size_t w = 0; w < words; ++w)
+          row_i[w] |= row_k[w];
+      }
+    }
+    for (std::size_t u = 0; u < size(); ++u)
+      result.degrees_[u] = reach[u].count();
+    result.incoming_ = transpose(reach);
+    return result;
+  }
+
+private:
+  void set_edge(std::size_t u, std::size_t v, bool value) {
+    if (adjacency_.test(u, v) == value)
+      return;
+    adjacency_.set(u, v, value);
+    if (value)
+      ++degrees_[u];
+    else
+      --degrees_[u];
+    if (directed_)
+      incoming_.set(v, u, value);
+  }
+
+  bit_matrix adjacency_;
+  bool directed_;
+  std::vector<std::size_t> degrees_;
+  /// Transposed adjacency of directed graphs for bottom-up steps, empty for
+  /// undirected graphs.
+  bit_matrix incoming_;
+};
+
+#endif
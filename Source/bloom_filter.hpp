@@ -0,0 +1,476 @@
+#ifndef BLOOM_FILTER_H_
+#define BLOOM_FILTER_H_
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+template <typename Key, typename Hasher> class counting_bloom_filter;
+
+/**
+ * @brief Geometry shared by the blocked Bloom filters.
+ *
+ * A key selects one 512 bit block (one cache line, eight words) and sets one
+ * bit in every word of it. The bit of word i is the top six bits of the low
+ * half of the key hash multiplied by an odd salt, which is the layout of the
+ * split block Bloom filter and maps to a single vector multiply and shift.
+ */
+namespace bloom_block {
+/**
+ * @brief Amount of words in a block.
+ */
+constexpr std::size_t words = 8;
+
+/**
+ * @brief Amount of bits in a block.
+ */
+constexpr std::size_t bits = words * bit_word::bits;
+
+/**
+ * @brief Odd multipliers selecting the bit of every word of a block.
+ */
+inline const std::uint32_t *salts() {
+  static const std::uint32_t values[words] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+  return values;
+}
+
+/**
+ * @brief Block of a hash among block_count blocks.
+ */
+inline std::size_t block_of(std::uint64_t hash, std::size_t block_count) {
+  return static_cast<std::size_t>(((hash >> 32) * block_count) >> 32);
+}
+
+/**
+ * @brief Index of the bit set in word i of the block.
+ */
+inline unsigned bit_of(std::uint64_t hash, std::size_t i) {
+  return static_cast<std::uint32_t>(static_cast<std::uint32_t>(hash) *
+                                    salts()[i]) >>
+         26;
+}
+
+/**
+ * @brief Set the probe bits of hash in block.
+ */
+inline void insert(bit_word::word_type *block, std::uint64_t hash) {
+#if defined(__AVX512F__)
+  const __m256i index = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)),
+                         _mm256_loadu_si256(
+                             reinterpret_cast<const __m256i *>(salts()))),
+      26);
+  const __m512i mask =
+      _mm512_sllv_epi64(_mm512_set1_epi64(1), _mm512_cvtepu32_epi64(index));
+  _mm512_store_si512(block, _mm512_or_si512(_mm512_load_si512(block), mask));
+#elif defined(__AVX2__)
+  const __m256i index = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)),
+                         _mm256_loadu_si256(
+                             reinterpret_cast<const __m256i *>(salts()))),
+      26);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i low = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(index)));
+  const __m256i high = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(index, 1)));
+  auto *lanes = reinterpret_cast<__m256i *>(block);
+  _mm256_store_si256(lanes, _mm256_or_si256(_mm256_load_si256(lanes), low));
+  _mm256_store_si256(lanes + 1,
+                     _mm256_or_si256(_mm256_load_si256(lanes + 1), high));
+#else
+  for (std::size_t i = 0; i < words; ++i)
+    block[i] |= bit_word::word_type(1) << bit_of(hash, i);
+#endif
+}
+
+/**
+ * @brief Check if every probe bit of hash is set in block.
+ */
+inline bool contains(const bit_word::word_type *block, std::uint64_t hash) {
+#if defined(__AVX512F__)
+  const __m256i index = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)),
+                         _mm256_loadu_si256(
+                             reinterpret_cast<const __m256i *>(salts()))),
+      26);
+  const __m512i mask =
+      _mm512_sllv_epi64(_mm512_set1_epi64(1), _mm512_cvtepu32_epi64(index));
+  const __m512i missing = _mm512_andnot_si512(_mm512_load_si512(block), mask);
+  return _mm512_test_epi64_mask(missing, missing) == 0;
+#elif defined(__AVX2__)
+  const __m256i index = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)),
+                         _mm256_loadu_si256(
+                             reinterpret_cast<const __m256i *>(salts()))),
+      26);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i low = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(index)));
+  const __m256i high = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(index, 1)));
+  const auto *lanes = reinterpret_cast<const __m256i *>(block);
+  return _mm256_testc_si256(_mm256_load_si256(lanes), low) &&
+         _mm256_testc_si256(_mm256_load_si256(lanes + 1), high);
+#else
+  bit_word::word_type missing = 0;
+  for (std::size_t i = 0; i < words; ++i)
+    missing |= ~block[i] & (bit_word::word_type(1) << bit_of(hash, i));
+  return missing == 0;
+#endif
+}
+
+/**
+ * @brief Amount of blocks for expected_items keys at false_positive_rate.
+ */
+inline std::size_t blocks_for(std::size_t expected_items,
+                              double false_positive_rate) {
+  if (!(false_positive_rate > 0 && false_positive_rate < 1))
+    throw std::invalid_argument(
+        "bloom_filter false positive rate must be in (0, 1)");
+  const double ln2 = std::log(2.0);
+  const double bit_count = -static_cast<double>(std::max<std::size_t>(
+                               expected_items, 1)) *
+                           std::log(false_positive_rate) / (ln2 * ln2);
+  return std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::ceil(bit_count / bits)));
+}
+
+/**
+ * @brief Hint the cache to load the line of an address.
+ */
+inline void prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  (void)address;
+#endif
+}
+} // namespace bloom_block
+
+/**
+ * @brief A blocked Bloom filter stored in a word_bitset.
+ *
+ * Every lookup touches exactly one cache line. The probes of a block are
+ * evaluated with AVX-512 or AVX2 when the translation unit is compiled for
+ * them and with a branch free word loop otherwise. Batch operations hash a
+ * group of keys and prefetch their blocks before probing them.
+ *
+ * Filters of equal geometry can be combined with | (union) and & (an
+ * approximation of the intersection that never has false negatives).
+ *
+ * @tparam Key Type of the stored keys.
+ * @tparam Hasher Hash function object for Key, the result is mixed again so
+ * identity hashes are fine.
+ */
+template <typename Key, typename Hasher = std::hash<Key>> class bloom_filter {
+public:
+  /**
+   * @brief Constructor that sizes the filter for a workload.
+   *
+   * @param expected_items Amount of keys that will be inserted.
+   * @param false_positive_rate Target false positive rate, in (0, 1).
+   * @param hasher Hash function object.
+   */
+  explicit bloom_filter(std::size_t expected_items,
+                        double false_positive_rate = 0.01,
+                        Hasher hasher = Hasher())
+      : blocks_(bloom_block::blocks_for(expected_items, false_positive_rate)),
+        bits_(blocks_ * bloom_block::bits), hasher_(hasher) {}
+
+  /**
+   * @brief Return amount of blocks
+   * @return Amount of cache line blocks
+   */
+  std::size_t block_count() const { return blocks_; }
+
+  /**
+   * @brief Return size of the filter
+   * @return Amount of bits
+   */
+  std::size_t size() const { return bits_.size(); }
+
+  /**
+   * @brief Access the underlying bits.
+   * @return Packed bits of the filter.
+   */
+  const word_bitset &bits() const { return bits_; }
+
+  /**
+   * @brief Insert a key.
+   * @param key The key to insert.
+   */
+  void insert(const Key &key) {
+    const std::uint64_t h = hash(key);
+    bloom_block::insert(block(h), h);
+  }
+
+  /**
+   * @brief Check if a key may have been inserted.
+   * @param key The key to look up.
+   * @return False if the key was never inserted, true otherwise.
+   */
+  bool contains(const Key &key) const {
+    const std::uint64_t h = hash(key);
+    return bloom_block::contains(block(h), h);
+  }
+
+  /**
+   * @brief Insert count keys, prefetching the blocks of every group.
+   * @param keys Pointer to the first key.
+   * @param count Amount of keys.
+   */
+  void insert_many(const Key *keys, std::size_t count) {
+    std::uint64_t hashes[group];
+    for (std::size_t first = 0; first < count; first += group) {
+      const std::size_t n = count - first < group ? count - first : group;
+      hash_group(keys + first, n, hashes);
+      for (std::size_t i = 0; i < n; ++i)
+        bloom_block::insert(block(hashes[i]), hashes[i]);
+    }
+  }
+
+  /**
+   * @brief Insert every key of a vector.
+   * @param keys The keys to insert.
+   */
+  void insert_many(const std::vector<Key> &keys) {
+    insert_many(keys.data(), keys.size());
+  }
+
+  /**
+   * @brief Look up count keys, prefetching the blocks of every group.
+   * @param keys Pointer to the first key.
+   * @param count Amount of keys.
+   * @return Bit i is set if keys[i] may have been inserted.
+   */
+  word_bitset contains_many_words(const Key *keys, std::size_t count) const {
+    word_bitset result(count);
+    std::uint64_t hashes[group];
+    for (std::size_t first = 0; first < count; first += group) {
+      const std::size_t n = count - first < group ? count - first : group;
+      hash_group(keys + first, n, hashes);
+      for (std::size_t i = 0; i < n; ++i)
+        if (bloom_block::contains(block(hashes[i]), hashes[i]))
+          result.set(first + i, true);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Look up every key of a vector.
+   * @param keys The keys to look up.
+   * @return dynamic_bitset, bit i is set if keys[i] may have been inserted.
+   */
+  dynamic_bitset<> contains_many(const std::vector<Key> &keys) const {
+    return contains_many_words(keys.data(), keys.size()).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Remove every key.
+   */
+  void clear() { bits_.reset(); }
+
+  /**
+   * @brief Union with a filter of the same geometry.
+   * @return bloom_filter itself
+   */
+  bloom_filter &operator|=(const bloom_filter &other) {
+    check_geometry(other);
+    bits_ |= other.bits_;
+    return *this;
+  }
+
+  /**
+   * @brief Intersection with a filter of the same geometry.
+   * @return bloom_filter itself
+   */
+  bloom_filter &operator&=(const bloom_filter &other) {
+    check_geometry(other);
+    bits_ &= other.bits_;
+    return *this;
+  }
+
+  /**
+   * @brief or operator between two bloom_filter
+   * @return return new bloom_filter
+   */
+  bloom_filter operator|(const bloom_filter &other) const {
+    bloom_filter result(*this);
+    result |= other;
+    return result;
+  }
+
+  /**
+   * @brief and operator between two bloom_filter
+   * @return return new bloom_filter
+   */
+  bloom_filter operator&(const bloom_filter &other) const {
+    bloom_filter result(*this);
+    result &= other;
+    return result;
+  }
+
+private:
+  friend class counting_bloom_filter<Key, Hasher>;
+
+  static constexpr std::size_t group = 16;
+
+  std::uint64_t hash(const Key &key) const {
+    return bit_word::mix(static_cast<std::uint64_t>(hasher_(key)));
+  }
+
+  bit_word::word_type *block(std::uint64_t hash) {
+    return bits_.data() +
+           bloom_block::block_of(hash, blocks_) * bloom_block::words;
+  }
+
+  const bit_word::word_type *block(std::uint64_t hash) const {
+    return bits_.data() +
+           bloom_block::block_of(hash, blocks_) * bloom_block::words;
+  }
+
+  /**
+   * @brief Hash n keys and prefetch their blocks.
+   */
+  void hash_group(const Key *keys, std::size_t n,
+                  std::uint64_t *hashes) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      hashes[i] = hash(keys[i]);
+      bloom_block::prefetch(block(hashes[i]));
+    }
+  }
+
+  void check_geometry(const bloom_filter &other) const {
+    if (blocks_ != other.blocks_)
+      throw std::invalid_argument("bloom_filter sizes do not match");
+  }
+
+  std::size_t blocks_;
+  word_bitset bits_;
+  Hasher hasher_;
+};
+
+/**
+ * @brief A blocked Bloom filter with one byte counter per bit, which allows
+ * removing keys.
+ *
+ * The counters use the geometry of bloom_filter, so to_bloom_filter() returns
+ * a plain filter that answers the same lookups. Counters saturate at 255 and
+ * are never decremented once saturated.
+ *
+ * @tparam Key Type of the stored keys.
+ * @tparam Hasher Hash function object for Key.
+ */
+template <typename Key, typename Hasher = std::hash<Key>>
+class counting_bloom_filter {
+public:
+  /**
+   * @brief Constructor that sizes the filter for a workload.
+   *
+   * @param expected_items Amount of keys that will be stored at once.
+   * @param false_positive_rate Target false positive rate, in (0, 1).
+   * @param hasher Hash function object.
+   */
+  explicit counting_bloom_filter(std::size_t expected_items,
+                                 double false_positive_rate = 0.01,
+                                 Hasher hasher = Hasher())
+      : expected_items_(expected_items),
+        false_positive_rate_(false_positive_rate),
+        blocks_(bloom_block::blocks_for(expected_items, false_positive_rate)),
+        counters_(blocks_ * bloom_block::bits, 0), hasher_(hasher) {}
+
+  /**
+   * @brief Return amount of blocks
+   * @return Amount of blocks
+   */
+  std::size_t block_count() const { return blocks_; }
+
+  /**
+   * @brief Insert a key.
+   * @param key The key to insert.
+   */
+  void insert(const Key &key) {
+    const std::uint64_t h = hash(key);
+    for (std::size_t i = 0; i < bloom_block::words; ++i) {
+      auto &counter = counters_[counter_index(h, i)];
+      if (counter != saturated)
+        ++counter;
+    }
+  }
+
+  /**
+   * @brief Remove a key that was inserted before.
+   * @param key The key to remove.
+   * @return False if the key was not present, the filter is unchanged then.
+   */
+  bool remove(const Key &key) {
+    if (!contains(key))
+      return false;
+    const std::uint64_t h = hash(key);
+    for (std::size_t i = 0; i < bloom_block::words; ++i) {
+      auto &counter = counters_[counter_index(h, i)];
+      if (counter != saturated)
+        --counter;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check if a key may be present.
+   * @param key The key to look up.
+   * @return False if the key is not present, true otherwise.
+   */
+  bool contains(const Key &key) const {
+    const std::uint64_t h = hash(key);
+    for (std::size_t i = 0; i < bloom_block::words; ++i)
+      if (!counters_[counter_index(h, i)])
+        return false;
+    return true;
+  }
+
+  /**
+   * @brief Plain filter with a bit set for every non zero counter.
+   * @return New bloom_filter of the same geometry.
+   */
+  bloom_filter<Key, Hasher> to_bloom_filter() const {
+    bloom_filter<Key, Hasher> filter(expected_items_, false_positive_rate_,
+                                     hasher_);
+    for (std::size_t i = 0; i < counters_.size(); ++i)
+      if (counters_[i])
+        filter.bits_.set(i, true);
+    return filter;
+  }
+
+private:
+  static constexpr std::uint8_t saturated = 255;
+
+  std::uint64_t hash(const Key &key) const {
+    return bit_word::mix(static_cast<std::uint64_t>(hasher_(key)));
+  }
+
+  std::size_t counter_index(std::uint64_t hash, std::size_t i) const {
+    return bloom_block::block_of(hash, blocks_) * bloom_block::bits +
+           i * bit_word::bits + bloom_block::bit_of(hash, i);
+  }
+
+  std::size_t expected_items_;
+  double false_positive_rate_;
+  std::size_t blocks_;
+  std::vector<std::uint8_t> counters_;
+  Hasher hasher_;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef CELLULAR_AUTOMATON_H_
+#define CELLULAR_AUTOMATON_H_
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "bit_matrix.hpp"
+#include "dynamic_bitset.hpp"
+#include "ternary.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Word kernels for cellular automata. A row of cells is a run of
+ * words, cell i in bit i, and a whole word of cells is updated at once from
+ * the row shifted by one cell in either direction.
+ */
+namespace cellular_automaton {
+using word_type = bit_word::word_type;
+
+/**
+ * @brief Word w of a row and of the row moved by one cell each way.
+ *
+ * @param row Words of the row.
+ * @param words Amount of words of the row.
+ * @param size Amount of cells of the row.
+ * @param w Index of the word.
+ * @param wrap True to join both ends of the row, otherwise the cells outside
+ * are dead.
+ * @param left Receives the left neighbours, bit i holds cell i - 1.
+ * @param right Receives the right neighbours, bit i holds cell i + 1.
+ */
+inline void neighbors(const word_type *row, std::size_t words,
+                      std::size_t size, std::size_t w, bool wrap,
+                      word_type &left, word_type &right) {
+  const std::size_t last = (size - 1) % bit_word::bits;
+  left = row[w] << 1;
+  if (w > 0)
+    left |= row[w - 1] >> (bit_word::bits - 1);
+  else if (wrap)
+    left |= (row[words - 1] >> last) & 1;
+  right = row[w] >> 1;
+  if (w + 1 < words)
+    right |= row[w + 1] << (bit_word::bits - 1);
+  else if (wrap)
+    right |= (row[0] & 1) << last;
+}
+
+/**
+ * @brief Bit sliced sum of three words with a full adder.
+ */
+inline void full_add(word_type a, word_type b, word_type c, word_type &sum,
+                     word_type &carry) {
+  sum = ternary_logic::word<0x96>(a, b, c);
+  carry = ternary_logic::word<0xE8>(a, b, c);
+}
+
+/**
+ * @brief One Life generation of a row.
+ *
+ * The eight neighbour words are summed with full and half adders into the
+ * bit slices ones, twos and fours of the count modulo 8, so a cell is alive
+ * next when the count is 3, or 2 and the cell is alive, and a count of 8
+ * wraps to 0 and dies as it should.
+ *
+ * @param above Row above, nullptr for a dead border.
+ * @param row The row.
+ * @param below Row below, nullptr for a dead border.
+ * @param out Receives the next generation of the row.
+ * @param words Amount of words per row.
+ * @param size Amount of cells per row.
+ * @param wrap True to join the ends of the rows.
+ */
+inline void life_row(const word_type *above, const word_type *row,
+                     const word_type *below, word_type *out,
+                     std::size_t words, std::size_t size, bool wrap) {
+  for (std::size_t w = 0; w < words; ++w) {
+    word_type left, right;
+    word_type s_above = 0, c_above = 0, s_below = 0, c_below = 0;
+    if (above) {
+      neighbors(above, words, size, w, wrap, left, right);
+      full_add(left, above[w], right, s_above, c_above);
+    }
+    if (below) {
+      neighbors(below, words, size, w, wrap, left, right);
+      full_add(left, below[w], right, s_below, c_below);
+    }
+    neighbors(row, words, size, w, wrap, left, right);
+    const word_type s_row = left ^ right;
+    const word_type c_row = left & right;
+    word_type ones, twos_low, twos_sum, fours_low;
+    full_add(s_above, s_row, s_below, ones, twos_low);
+    full_add(c_above, c_row, c_below, twos_sum, fours_low);
+    const word_type twos = twos_sum ^ twos_low;
+    const word_type fours = fours_low ^ (twos_sum & twos_low);
+    out[w] = twos & ~fours & (ones | row[w]);
+  }
+  const std::size_t used = size % bit_word::bits;
+  if (used)
+    out[words - 1] &= bit_word::low_mask(used);
+}
+} // namespace cellular_automaton
+
+/**
+ * @brief One step of an elementary cellular automaton with a rule known at
+ * compile time.
+ *
+ * Bit ((l << 2) | (c << 1) | r) of a Wolfram rule number is the next state of
+ * a cell with left neighbour l, state c and right neighbour r, which is the
+ * truth table encoding of ternary_logic, so a word of cells takes a single
+ * ternary evaluation.
+ *
+ * @tparam Rule Wolfram rule number, 30 and 110 being the classic ones.
+ * @param cells Current generation, cell i in bit i.
+ * @param wrap True for a ring of cells, otherwise the cells outside are dead.
+ * @return New word_bitset with the next generation.
+ */
+template <unsigned Rule>
+word_bitset elementary_step(const word_bitset &cells, bool wrap = false) {
+  word_bitset result(cells.size());
+  const std::size_t words = cells.word_count();
+  bit_word::word_type *out = result.data();
+  for (std::size_t w = 0; w < words; ++w) {
+    bit_word::word_type left, right;
+    cellular_automaton::neighbors(cells.data(), words, cells.size(), w, wrap,
+                                  left, right);
+    out[w] = ternary_logic::word<Rule>(left, cells.data()[w], right);
+  }
+  result.trim();
+  return result;
+}
+
+/**
+ * @brief One step of an elementary cellular automaton with a rule given at
+ * run time, see elementary_step<Rule>.
+ *
+ * @param cells Current generation, cell i in bit i.
+ * @param rule Wolfram rule number in [0, 255].
+ * @param wrap True for a ring of cells, otherwise the cells outside are dead.
+ * @return New word_bitset with the next generation.
+ */
+inline word_bitset elementary_step(const word_bitset &cells, unsigned rule,
+                                   bool wrap = false) {
+  word_bitset result(cells.size());
+  const std::size_t words = cells.word_count();
+  bit_word::word_type *out = result.data();
+  for (std::size_t w = 0; w < words; ++w) {
+    bit_word::word_type left, right;
+    cellular_automaton::neighbors(cells.data(), words, cells.size(), w, wrap,
+                                  left, right);
+    const bit_word::word_type center = cells.data()[w];
+    // or of the minterms of the neighbourhoods the rule maps to 1
+    bit_word::word_type next = 0;
+    for (unsigned k = 0; k < 8; ++k)
+      if ((rule >> k) & 1)
+        next |= (k & 4 ? left : ~left) & (k & 2 ? center : ~center) &
+                (k & 1 ? right : ~right);
+    out[w] = next;
+  }
+  result.trim();
+  return result;
+}
+
+/**
+ * @brief One step of an elementary cellular automaton on a dynamic_bitset,
+ * cell i at index i.
+ * @return New dynamic_bitset with the next generation.
+ */
+template <std::size_t N>
+dynamic_bitset<> elementary_step(const dynamic_bitset<N> &cells, unsigned rule,
+                                 bool wrap = false) {
+  return elementary_step(word_bitset(cells), rule, wrap).to_dynamic_bitset();
+}
+
+/**
+ * @brief One generation of Conway's Game of Life.
+ *
+ * Every row is updated from the rows above and below with the adder network
+ * of cellular_automaton::life_row. With threads > 1 the grid is cut into
+ * bands of consecutive rows, one per thread.
+ *
+ * @param grid Current generation, entry (i, j) is the cell at row i, column j.
+ * @param wrap True for a torus, otherwise the cells outside are dead.
+ * @param threads Amount of threads, 0 uses the hardware concurrency.
+ * @return return new bit_matrix with the next generation
+ */
+inline bit_matrix life_step(const bit_matrix &grid, bool wrap = false,
+                            std::size_t threads = 1) {
+  const std::size_t rows = grid.rows();
+  bit_matrix result(rows, grid.cols());
+  if (rows == 0 || grid.cols() == 0)
+    return result;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::max<std::size_t>(1, std::min(threads, rows));
+
+  auto work = [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      const bit_word::word_type *above = nullptr, *below = nullptr;
+      if (i > 0 || wrap)
+        above = grid.row_data((i + rows - 1) % rows);
+      if (i + 1 < rows || wrap)
+        below = grid.row_data((i + 1) % rows);
+      cellular_automaton::life_row(above, grid.row_data(i), below,
+                                   result.row_data(i), grid.words_per_row(),
+                                   grid.cols(), wrap);
+    }
+  };
+  std::vector<std::thread> workers;
+  const std::size_t band = (rows + threads - 1) / threads;
+  for (std::size_t t = 1; t < threads; ++t)
+    workers.emplace_back(work, std::min(rows, t * band),
+                         std::min(rows, (t + 1) * band));
+  work(0, std::min(rows, band));
+  for (auto &worker : workers)
+    worker.join();
+  return result;
+}
+
+/**
+ * @brief One generation of Conway's Game of Life on rows of equal size, see
+ * life_step(const bit_matrix &, bool, std::size_t).
+ * @return New rows with the next generation.
+ */
+template <std::size_t N>
+std::vector<dynamic_bitset<>>
+life_step(const std::vector<dynamic_bitset<N>> &rows, bool wrap = false,
+          std::size_t threads = 1) {
+  const bit_matrix next = life_step(bit_matrix(rows), wrap, threads);
+  std::vector<dynamic_bitset<>> result;
+  result.reserve(next.rows());
+  for (std::size_t i = 0; i < next.rows(); ++i)
+    result.push_back(next[i].to_dynamic_bitset());
+  return result;
+}
+
+#endif
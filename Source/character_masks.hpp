@@ -0,0 +1,85 @@
+#ifndef CHARACTER_MASKS_H_
+#define CHARACTER_MASKS_H_
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "word_bitset.hpp"
+
+/**
+ * @brief Per character occurrence masks of a pattern, the precomputed table
+ * of bit-parallel string algorithms.
+ *
+ * Bit i of the mask of c is set when pattern[i] == c. Only the characters of
+ * the pattern get a mask of their own, every other byte shares one all zero
+ * mask, so long patterns over small alphabets stay compact.
+ */
+class character_masks {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that builds the masks of a pattern.
+   * @param pattern Pattern, characters are bytes.
+   */
+  explicit character_masks(const std::string &pattern)
+      : size_(pattern.size()), words_(bit_word::words_for(pattern.size())) {
+    slot_.fill(0);
+    masks_.assign(words_, 0);
+    for (std::size_t i = 0; i < size_; ++i) {
+      const unsigned char c = static_cast<unsigned char>(pattern[i]);
+      if (slot_[c] == 0) {
+        slot_[c] = static_cast<std::uint16_t>(masks_.size() / words_);
+        masks_.resize(masks_.size() + words_, 0);
+      }
+      masks_[slot_[c] * words_ + i / bit_word::bits] |=
+          word_type(1) << (i % bit_word::bits);
+    }
+  }
+
+  /**
+   * @brief Return length of the pattern
+   * @return Amount of characters
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Return amount of words of every mask
+   * @return Amount of words
+   */
+  std::size_t word_count() const { return words_; }
+
+  /**
+   * @brief Mask of a character.
+   * @param c Character.
+   * @return Pointer to word_count() words.
+   */
+  const word_type *operator[](char c) const {
+    return masks_.data() + slot_[static_cast<unsigned char>(c)] * words_;
+  }
+
+  /**
+   * @brief Mask of the pattern bits held by the last word.
+   * @return Mask word.
+   */
+  word_type top_mask() const {
+    return bit_word::low_mask(size_ - (words_ - 1) * bit_word::bits);
+  }
+
+  /**
+   * @brief Single bit mask of the last pattern character in the last word.
+   * @return Mask word.
+   */
+  word_type last_bit() const {
+    return word_type(1) << ((size_ - 1) % bit_word::bits);
+  }
+
+private:
+  std::size_t size_;
+  std::size_t words_;
+  std::array<std::uint16_t, 256> slot_;
+  bit_word::word_vector masks_;
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef CLIQUE_SOLVER_H_
+#define CLIQUE_SOLVER_H_
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "bitset_graph.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Exact maximum clique by bitset branch and bound (BBMC).
+ *
+ * Vertices are renumbered by decreasing degree. Every search node greedily
+ * colors its candidate set with bitset color classes, each class built by
+ * repeated find_first and an and-not with the neighbours of the picked
+ * vertex, and branches on the vertices in reverse color order. A branch is
+ * cut as soon as the clique plus the color of the vertex cannot beat the best
+ * clique, and vertices whose color is too small to matter are never listed.
+ *
+ * The candidate, coloring and order buffers of every depth come from a pool
+ * that is allocated once, so the search itself does not allocate.
+ */
+class clique_solver {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that prepares the solver for an undirected graph.
+   * @param graph Graph to search, self loops are ignored.
+   */
+  explicit clique_solver(const bitset_graph &graph)
+      : clique_solver(graph.size(), [&graph](std::size_t u, std::size_t v) {
+          return graph.has_edge(u, v);
+        }) {
+    if (graph.directed())
+      throw std::invalid_argument("clique_solver needs an undirected graph");
+  }
+
+  /**
+   * @brief Constructor that takes adjacency rows, bit v of row u set for an
+   * edge between u and v. Edges are symmetrized.
+   */
+  template <std::size_t N>
+  explicit clique_solver(const std::vector<dynamic_bitset<N>> &rows)
+      : clique_solver(rows.size(), [&rows](std::size_t u, std::size_t v) {
+          return rows[u][v] || rows[v][u];
+        }) {}
+
+  /**
+   * @brief Return amount of vertices
+   * @return Amount of vertices
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Search nodes expanded by the last call of solve().
+   */
+  std::size_t nodes() const { return nodes_; }
+
+  /**
+   * @brief Find a maximum clique.
+   * @return Vertices of the clique in increasing order.
+   */
+  std::vector<std::size_t> solve() {
+    nodes_ = 0;
+    current_.clear();
+    best_.clear();
+    if (size_ == 0)
+      return {};
+    word_type *candidates = level_buffer(0).candidates.data();
+    std::fill(candidates, candidates + words_, ~word_type(0));
+    candidates[words_ - 1] &=
+        bit_word::low_mask(size_ - (words_ - 1) * bit_word::bits);
+    expand(0);
+    std::vector<std::size_t> result;
+    for (std::size_t v : best_)
+      result.push_back(order_[v]);
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+private:
+  /// Buffers of one search depth.
+  struct level {
+    bit_word::word_vector candidates;
+    bit_word::word_vector uncolored;
+    bit_word::word_vector color_class;
+    std::vector<std::size_t> vertices;
+    std::vector<std::size_t> colors;
+  };
+
+  template <typename Edge>
+  clique_solver(std::size_t size, Edge edge)
+      : size_(size), words_(bit_word::words_for(size)), order_(size),
+        rows_(size * words_, 0) {
+    std::vector<std::size_t> degree(size, 0);
+    for (std::size_t u = 0; u < size; ++u)
+      for (std::size_t v = 0; v < size; ++v)
+        degree[u] += u != v && edge(u, v);
+    std::iota(order_.begin(), order_.end(), std::size_t(0));
+    std::stable_sort(order_.begin(), order_.end(),
+                     [&degree](std::size_t a, std::size_t b) {
+                       return degree[a] > degree[b];
+                     });
+    for (std::size_t i = 0; i < size; ++i)
+      for (std::size_t j = 0; j < size; ++j)
+        if (i != j && edge(order_[i], order_[j]))
+          rows_[i * words_ + j / bit_word::bits] |= word_type(1)
+                                                    << (j % bit_word::bits);
+    // one level per possible clique vertex plus the leaf level
+    pool_.resize(size + 1);
+    current_.reserve(size);
+    best_.reserve(size);
+  }
+
+  level &level_buffer(std::size_t depth) {
+    level &buffer = pool_[depth];
+    if (buffer.candidates.empty()) {
+      buffer.candidates.resize(words_);
+      buffer.uncolored.resize(words_);
+      buffer.color_class.resize(words_);
+      buffer.vertices.reserve(size_);
+      buffer.colors.reserve(size_);
+    }
+    return buffer;
+  }
+
+  const word_type *row(std::size_t v) const {
+    return rows_.data() + v * words_;
+  }
+
+  static std::size_t find_first(const word_type *words, std::size_t count) {
+    for (std::size_t w = 0; w < count; ++w)
+      if (words[w])
+        return w * bit_word::bits + bit_word::count_trailing_zeros(words[w]);
+    return bit_word::npos;
+  }
+
+  static void clear(word_type *words, std::size_t v) {
+    words[v / bit_word::bits] &= ~(word_type(1) << (v % bit_word::bits));
+  }
+
+  /**
+   * @brief Greedy sequential coloring of the candidates, listing the vertices
+   * whose color is at least min_color in increasing color order.
+   */
+  void color(level &buffer, std::size_t min_color) {
+    buffer.vertices.clear();
+    buffer.colors.clear();
+    word_type *uncolored = buffer.uncolored.data();
+    word_type *color_class = buffer.color_class.data();
+    std::copy(buffer.candidates.begin(), buffer.candidates.end(), uncolored);
+    std::size_t first_word = 0;
+    for (std::size_t k = 1;; ++k) {
+      while (first_word < words_ && !uncolored[first_word])
+        ++first_word;
+      if (first_word == words_)
+        return;
+      std::copy(uncolored + first_word, uncolored + words_,
+                color_class + first_word);
+      for (std::size_t v = find_first(color_class + first_word,
+                                      words_ - first_word);
+           v != bit_word::npos;) {
+        v += first_word * bit_word::bits;
+        clear(uncolored, v);
+        // the rest of the class must not be adjacent to v
+        const word_type *neighbors = row(v);
+        for (std::size_t w = v / bit_word::bits; w < words_; ++w)
+          color_class[w] &= ~neighbors[w];
+        clear(color_class, v);
+        if (k >= min_color) {
+          buffer.vertices.push_back(v);
+          buffer.colors.push_back(k);
+        }
+        v = find_first(color_class + first_word, words_ - first_word);
+      }
+    }
+  }
+
+  void expand(std::size_t depth) {
+    ++nodes_;
+    level &buffer = level_buffer(depth);
+    const std::size_t needed = best_.size() + 1;
+    color(buffer, needed > current_.size() ? needed - current_.size() : 1);
+    word_type *candidates = buffer.candidates.data();
+    for (std::size_t i = buffer.vertices.size(); i-- > 0;) {
+      const std::size_t v = buffer.vertices[i];
+      if (current_.size() + buffer.colors[i] <= best_.size())
+        return;
+      current_.push_back(v);
+      word_type *next = level_buffer(depth + 1).candidates.data();
+      const word_type *neighbors = row(v);
+      word_type any = 0;
+      for (std::size_t w = 0; w < words_; ++w) {
+        next[w] = candidates[w] & neighbors[w];
+        any |= next[w];
+      }
+      if (any)
+        expand(depth + 1);
+      else if (current_.size() > best_.size())
+        best_ = current_;
+      current_.pop_back();
+      clear(candidates, v);
+    }
+  }
+
+  std::size_t size_;
+  std::size_t words_;
+  /// order_[i] is the original id of renumbered vertex i.
+  std::vector<std::size_t> order_;
+  bit_word::word_vector rows_;
+  std::vector<level> pool_;
+  std::vector<std::size_t> current_;
+  std::vector<std::size_t> best_;
+  std::size_t nodes_ = 0;
+};
+
+/**
+ * @brief Maximum clique of an undirected graph, see clique_solver.
+ * @return Vertices of the clique in increasing order.
+ */
+inline std::vector<std::size_t> maximum_clique(const bitset_graph &graph) {
+  return clique_solver(graph).solve();
+}
+
+/**
+ * @brief Maximum independent set of an undirected graph, a maximum clique of
+ * the complement graph.
+ * @return Vertices of the set in increasing order.
+ */
+inline std::vector<std::size_t>
+maximum_independent_set(const bitset_graph &graph) {
+  bitset_graph complement(graph.size());
+  for (std::size_t u = 0; u < graph.size(); ++u)
+    for (std::size_t v = u + 1; v < graph.size(); ++v)
+      if (!graph.has_edge(u, v))
+        complement.add_edge(u, v);
+  return maximum_clique(complement);
+}
+
+#endif
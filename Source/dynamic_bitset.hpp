@@ -361,7 +361,7 @@ public:
       bits_.assign(bits_.size(), false);
     else {
       // shift all bits to left
-      for (std::size_t i = 0; i < bits_.size(); ++i)
+      for (std::size_t i = 0; i + shift_amount < bits_.size(); ++i)
         bits_[i] = bits_[i + shift_amount];
       // fill shifted position
       for (std::size_t i = bits_.size() - shift_amount; i < bits_.size(); ++i)
@@ -380,7 +380,7 @@ public:
       bits_.assign(bits_.size(), false);
     else {
       // shift all bits to  right
-      for (std::size_t i = bits_.size() - 1; i >= shift_amount; --i)
+      for (std::size_t i = bits_.size(); i-- > shift_amount;)
         bits_[i] = bits_[i - shift_amount];
       // fill shifted position
       for (std::size_t i = 0; i < shift_amount; ++i)
@@ -0,0 +1,424 @@
+#ifndef HAMMING_INDEX_H_
+#define HAMMING_INDEX_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Hamming distance kernels over rows padded to whole cache lines.
+ */
+namespace hamming_kernel {
+/**
+ * @brief Rows are padded to a multiple of this amount of words.
+ */
+constexpr std::size_t row_alignment = 8;
+
+/**
+ * @brief Hamming distance of two aligned rows.
+ *
+ * Uses AVX-512 VPOPCNTDQ, the AVX2 nibble lookup popcount or the scalar
+ * popcount depending on the target of the translation unit.
+ *
+ * @param a First row, aligned to 64 bytes.
+ * @param b Second row, aligned to 64 bytes.
+ * @param words Amount of words, a multiple of row_alignment.
+ * @return Amount of differing bits.
+ */
+inline std::size_t distance(const bit_word::word_type *a,
+                            const bit_word::word_type *b, std::size_t words) {
+#if defined(__AVX512VPOPCNTDQ__)
+  __m512i total = _mm512_setzero_si512();
+  for (std::size_t i = 0; i < words; i += 8)
+    total = _mm512_add_epi64(
+        total, _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_load_si512(a + i),
+                                                    _mm512_load_si512(b + i))));
+  return static_cast<std::size_t>(_mm512_reduce_add_epi64(total));
+#elif defined(__AVX2__)
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+  __m256i total = _mm256_setzero_si256();
+  for (std::size_t i = 0; i < words; i += 4) {
+    const __m256i x = _mm256_xor_si256(
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(a + i)),
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(b + i)));
+    const __m256i counts = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low_nibble)),
+        _mm256_shuffle_epi8(
+            lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibble)));
+    total = _mm256_add_epi64(total,
+                             _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+  return static_cast<std::size_t>(_mm256_extract_epi64(total, 0) +
+                                  _mm256_extract_epi64(total, 1) +
+                                  _mm256_extract_epi64(total, 2) +
+                                  _mm256_extract_epi64(total, 3));
+#else
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < words; ++i)
+    total += bit_word::popcount(a[i] ^ b[i]);
+  return total;
+#endif
+}
+} // namespace hamming_kernel
+
+/**
+ * @brief A match returned by hamming_index searches.
+ */
+struct hamming_match {
+  /// Id of the matching row.
+  std::size_t id;
+  /// Hamming distance between the row and the query.
+  std::size_t distance;
+
+  bool operator<(const hamming_match &other) const {
+    return distance != other.distance ? distance < other.distance
+                                      : id < other.id;
+  }
+
+  bool operator==(const hamming_match &other) const {
+    return id == other.id && distance == other.distance;
+  }
+};
+
+/**
+ * @brief Many binary codes of equal length in one contiguous matrix.
+ *
+ * Rows are stored back to back in cache line aligned storage, each padded to
+ * a whole amount of cache lines, so a scan is a linear walk with fused
+ * xor + popcount kernels (see hamming_kernel::distance).
+ *
+ * knn() scans every row unless build_multi_index() was called, in which case
+ * it uses multi-index hashing: the codes are cut into m substrings and, by the
+ * pigeonhole principle, every code within distance r of the query agrees with
+ * it up to floor(r / m) bits in at least one substring, so only the buckets
+ * around the query substrings are verified.
+ */
+class hamming_index {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates an empty index.
+   *
+   * @param bits Length of every code.
+   */
+  explicit hamming_index(std::size_t bits)
+      : bits_(bits), stride_(padded_words(bits)), rows_(0) {}
+
+  /**
+   * @brief Return length of the codes
+   * @return Amount of bits per code
+   */
+  std::size_t bits() const { return bits_; }
+
+  /**
+   * @brief Return amount of codes
+   * @return Amount of rows
+   */
+  std::size_t size() const { return rows_; }
+
+  /**
+   * @brief Return amount of words per row including padding
+   * @return Row stride in words
+   */
+  std::size_t stride() const { return stride_; }
+
+  /**
+   * @brief Words of a row.
+   * @param id Row id.
+   * @return Pointer to the first word, aligned to a cache line.
+   */
+  const word_type *row(std::size_t id) const {
+    return data_.data() + id * stride_;
+  }
+
+  /**
+   * @brief Append a code.
+   * @param code The code, size must equal bits().
+   * @return Id of the new row.
+   */
+  std::size_t add(const word_bitset &code) {
+    check_size(code.size());
+    data_.resize(data_.size() + stride_, 0);
+    std::copy(code.data(), code.data() + code.word_count(),
+              data_.end() - stride_);
+    index_row(rows_);
+    return rows_++;
+  }
+
+  /**
+   * @brief Append a code.
+   * @param code The code, size must equal bits().
+   * @return Id of the new row.
+   */
+  template <std::size_t N> std::size_t add(const dynamic_bitset<N> &code) {
+    return add(word_bitset(code));
+  }
+
+  /**
+   * @brief Hamming distance between a row and a code.
+   * @return Amount of differing bits.
+   */
+  std::size_t distance(std::size_t id, const word_bitset &code) const {
+    if (id >= rows_)
+      throw std::out_of_range("hamming_index id is out of range");
+    check_size(code.size());
+    const bit_word::word_vector query = pad(code);
+    return hamming_kernel::distance(row(id), query.data(), stride_);
+  }
+
+  /**
+   * @brief Cut the codes into substrings and hash every row by them.
+   *
+   * @param substrings Amount of substrings, every substring must be at most
+   * 32 bits long.
+   */
+  void build_multi_index(std::size_t substrings) {
+    substrings = std::max<std::size_t>(1, std::min(substrings, bits_));
+    substring_bits_ = (bits_ + substrings - 1) / substrings;
+    if (substring_bits_ > 32)
+      throw std::invalid_argument("hamming_index substrings are too long");
+    tables_.assign((bits_ + substring_bits_ - 1) / substring_bits_, table());
+    for (std::size_t id = 0; id < rows_; ++id)
+      index_row(id);
+  }
+
+  /**
+   * @brief Check if the multi-index is built
+   * @return True if searches use multi-index hashing
+   */
+  bool multi_indexed() const { return !tables_.empty(); }
+
+  /**
+   * @brief The k rows closest to a code.
+   * @param code The query, size must equal bits().
+   * @param k Amount of matches.
+   * @return Matches sorted by distance, then id.
+   */
+  std::vector<hamming_match> knn(const word_bitset &code,
+                                 std::size_t k) const {
+    check_size(code.size());
+    const bit_word::word_vector query = pad(code);
+    if (multi_indexed())
+      return knn_multi_index(query.data(), k);
+    return knn_scan(query.data(), k);
+  }
+
+  /**
+   * @brief The k rows closest to a code.
+   * @return Matches sorted by distance, then id.
+   */
+  template <std::size_t N>
+  std::vector<hamming_match> knn(const dynamic_bitset<N> &code,
+                                 std::size_t k) const {
+    return knn(word_bitset(code), k);
+  }
+
+  /**
+   * @brief Every row within radius of a code.
+   * @return Matches sorted by distance, then id.
+   */
+  std::vector<hamming_match> radius_search(const word_bitset &code,
+                                           std::size_t radius) const {
+    check_size(code.size());
+    const bit_word::word_vector query = pad(code);
+    std::vector<hamming_match> result;
+    for (std::size_t id = 0; id < rows_; ++id) {
+      const std::size_t d =
+          hamming_kernel::distance(row(id), query.data(), stride_);
+      if (d <= radius)
+        result.push_back({id, d});
+    }
+    return result;
+  }
+
+  /**
+   * @brief k nearest neighbours of many queries, split over threads.
+   * @param queries The queries.
+   * @param k Amount of matches per query.
+   * @param threads Amount of threads, 0 uses the hardware concurrency.
+   * @return Matches of queries[i] at index i.
+   */
+  std::vector<std::vector<hamming_match>>
+  knn_batch(const std::vector<word_bitset> &queries, std::size_t k,
+            std::size_t threads = 0) const {
+    std::vector<std::vector<hamming_match>> result(queries.size());
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<std::size_t>(1, std::min(threads, queries.size()));
+
+    auto work = [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i)
+        result[i] = knn(queries[i], k);
+    };
+    std::vector<std::thread> workers;
+    const std::size_t chunk = (queries.size() + threads - 1) / threads;
+    for (std::size_t t = 1; t < threads; ++t)
+      workers.emplace_back(work, std::min(queries.size(), t * chunk),
+                           std::min(queries.size(), (t + 1) * chunk));
+    work(0, std::min(queries.size(), chunk));
+    for (auto &worker : workers)
+      worker.join();
+    return result;
+  }
+
+private:
+  using table = std::unordered_map<std::uint32_t, std::vector<std::size_t>>;
+
+  static std::size_t padded_words(std::size_t bits) {
+    const std::size_t a = hamming_kernel::row_alignment;
+    return (bit_word::words_for(bits) + a - 1) / a * a;
+  }
+
+  void check_size(std::size_t size) const {
+    if (size != bits_)
+      throw std::invalid_argument("hamming_index code size does not match");
+  }
+
+  /**
+   * @brief Copy a code into an aligned, padded row.
+   */
+  bit_word::word_vector pad(const word_bitset &code) const {
+    bit_word::word_vector query(stride_, 0);
+    std::copy(code.data(), code.data() + code.word_count(), query.begin());
+    return query;
+  }
+
+  /**
+   * @brief Bits [j * substring_bits_, ...) of a row as an integer.
+   */
+  std::uint32_t substring(const word_type *words, std::size_t j) const {
+    const std::size_t first = j * substring_bits_;
+    const std::size_t length = std::min(substring_bits_, bits_ - first);
+    const std::size_t w = first / bit_word::bits;
+    const std::size_t offset = first % bit_word::bits;
+    word_type value = words[w] >> offset;
+    if (offset + length > bit_word::bits)
+      value |= words[w + 1] << (bit_word::bits - offset);
+    return static_cast<std::uint32_t>(value & bit_word::low_mask(length));
+  }
+
+  void index_row(std::size_t id) {
+    for (std::size_t j = 0; j < tables_.size(); ++j)
+      tables_[j][substring(row(id), j)].push_back(id);
+  }
+
+  /**
+   * @brief Keep the k best matches, sorted.
+   */
+  static void keep_best(std::vector<hamming_match> &matches, std::size_t k) {
+    if (matches.size() > k) {
+      std::nth_element(matches.begin(), matches.begin() + k, matches.end());
+      matches.resize(k);
+    }
+    std::sort(matches.begin(), matches.end());
+  }
+
+  std::vector<hamming_match> knn_scan(const word_type *query,
+                                      std::size_t k) const {
+    std::vector<hamming_match> heap;
+    if (k == 0)
+      return heap;
+    for (std::size_t id = 0; id < rows_; ++id) {
+      const hamming_match match{
+          id, hamming_kernel::distance(row(id), query, stride_)};
+      if (heap.size() < k) {
+        heap.push_back(match);
+        std::push_heap(heap.begin(), heap.end());
+      } else if (match < heap.front()) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = match;
+        std::push_heap(heap.begin(), heap.end());
+      }
+    }
+    std::sort_heap(heap.begin(), heap.end());
+    return heap;
+  }
+
+  /**
+   * @brief Multi-index search, growing the substring radius until the k-th
+   * match is known to be final.
+   */
+  std::vector<hamming_match> knn_multi_index(const word_type *query,
+                                             std::size_t k) const {
+    std::vector<hamming_match> found;
+    k = std::min(k, rows_);
+    if (k == 0)
+      return found;
+    word_bitset seen(rows_);
+    const std::size_t m = tables_.size();
+
+    for (std::size_t radius = 0; radius <= substring_bits_; ++radius) {
+      for (std::size_t j = 0; j < m; ++j) {
+        const std::size_t first = j * substring_bits_;
+        const std::size_t length = std::min(substring_bits_, bits_ - first);
+        if (radius > length)
+          continue;
+        const std::uint32_t key = substring(query, j);
+        for_each_flip(length, radius, [&](std::uint32_t flips) {
+          const auto bucket = tables_[j].find(key ^ flips);
+          if (bucket == tables_[j].end())
+            return;
+          for (const auto id : bucket->second) {
+            if (seen.test(id))
+              continue;
+            seen.set(id, true);
+            found.push_back(
+                {id, hamming_kernel::distance(row(id), query, stride_)});
+          }
+        });
+      }
+      // every row closer than m * (radius + 1) has been seen
+      if (found.size() >= k) {
+        keep_best(found, k);
+        if (found.back().distance < m * (radius + 1))
+          return found;
+      }
+    }
+    keep_best(found, k);
+    return found;
+  }
+
+  /**
+   * @brief Call function with every length bit mask of exactly count bits
+   * (Gosper's hack).
+   */
+  template <typename Function>
+  static void for_each_flip(std::size_t length, std::size_t count,
+                            Function function) {
+    if (count == 0) {
+      function(0);
+      return;
+    }
+    std::uint64_t mask = bit_word::low_mask(count);
+    const std::uint64_t limit = std::uint64_t(1) << length;
+    while (mask < limit) {
+      function(static_cast<std::uint32_t>(mask));
+      const std::uint64_t low = mask & (~mask + 1);
+      const std::uint64_t ripple = mask + low;
+      mask = (((ripple ^ mask) >> 2) / low) | ripple;
+    }
+  }
+
+  std::size_t bits_;
+  std::size_t stride_;
+  std::size_t rows_;
+  bit_word::word_vector data_;
+  std::size_t substring_bits_ = 0;
+  std::vector<table> tables_;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef LINEAR_COUNTER_H_
+#define LINEAR_COUNTER_H_
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "word_bitset.hpp"
+
+/**
+ * @brief Linear counting sketch for approximate distinct counts.
+ *
+ * Every key sets one bit of a bitmap of m bits chosen by its hash. With V the
+ * fraction of zero bits the amount of distinct keys is estimated as
+ * -m * ln(V), which needs a single popcount pass over the bitmap.
+ *
+ * The sketch of a union of streams is the or of their sketches, so shards
+ * can be counted independently and merged in any order. Sketches of
+ * different streams must have the same size and Hasher.
+ *
+ * @tparam Key Type of the counted keys.
+ * @tparam Hasher Hash function object for Key, the result is mixed again.
+ */
+template <typename Key, typename Hasher = std::hash<Key>> class linear_counter {
+public:
+  /**
+   * @brief Constructor that creates an empty sketch.
+   *
+   * @param bits Size of the bitmap.
+   * @param hasher Hash function object.
+   */
+  explicit linear_counter(std::size_t bits, Hasher hasher = Hasher())
+      : bits_(bits), hasher_(hasher) {
+    if (bits == 0)
+      throw std::invalid_argument("linear_counter needs at least one bit");
+  }
+
+  /**
+   * @brief Bitmap size for counting up to max_cardinality keys with a
+   * relative standard error below error.
+   *
+   * Uses the standard error of linear counting,
+   * sqrt(m * (e^t - t - 1)) / n with load factor t = n / m, and grows m
+   * until it is below error.
+   *
+   * @param max_cardinality Largest expected amount of distinct keys.
+   * @param error Relative standard error in (0, 1), e.g. 0.01.
+   * @return Amount of bits.
+   */
+  static std::size_t bits_for(std::size_t max_cardinality, double error) {
+    if (!(error > 0 && error < 1))
+      throw std::invalid_argument("linear_counter error must be in (0, 1)");
+    const double n =
+        static_cast<double>(std::max<std::size_t>(max_cardinality, 1));
+    double m = bit_word::bits;
+    while (true) {
+      const double t = n / m;
+      if (std::sqrt(m * (std::exp(t) - t - 1)) / n <= error)
+        return static_cast<std::size_t>(m);
+      m *= 1.25;
+    }
+  }
+
+  /**
+   * @brief Return size of the bitmap
+   * @return Amount of bits
+   */
+  std::size_t size() const { return bits_.size(); }
+
+  /**
+   * @brief Access the underlying bitmap.
+   * @return Packed bits of the sketch.
+   */
+  const word_bitset &bits() const { return bits_; }
+
+  /**
+   * @brief Count a key.
+   * @param key The key to count.
+   */
+  void insert(const Key &key) { bits_.set(position(key), true); }
+
+  /**
+   * @brief Count every key of a vector.
+   * @param keys The keys to count.
+   */
+  void insert_many(const std::vector<Key> &keys) {
+    for (const auto &key : keys)
+      bits_.set(position(key), true);
+  }
+
+  /**
+   * @brief Check if every bit is set, the estimate is a lower bound then.
+   * @return True if the sketch is saturated.
+   */
+  bool saturated() const { return bits_.all(); }
+
+  /**
+   * @brief Estimated amount of distinct keys.
+   * @return Estimate, m * ln(m) for a saturated sketch.
+   */
+  double estimate() const {
+    const double m = static_cast<double>(bits_.size());
+    const std::size_t zeros = bits_.size() - bits_.count();
+    if (zeros == 0)
+      return m * std::log(m);
+    return -m * std::log(static_cast<double>(zeros) / m);
+  }
+
+  /**
+   * @brief Remove every key.
+   */
+  void clear() { bits_.reset(); }
+
+  /**
+   * @brief Merge the sketch of another stream.
+   * @return linear_counter itself
+   */
+  linear_counter &operator|=(const linear_counter &other) {
+    if (bits_.size() != other.bits_.size())
+      throw std::invalid_argument("linear_counter sizes do not match");
+    bits_ |= other.bits_;
+    return *this;
+  }
+
+  /**
+   * @brief Sketch of the union of two streams.
+   * @return return new linear_counter
+   */
+  linear_counter operator|(const linear_counter &other) const {
+    linear_counter result(*this);
+    result |= other;
+    return result;
+  }
+
+  /**
+   * @brief Estimated amount of keys seen by both sketches, by inclusion and
+   * exclusion.
+   * @return Estimate, never negative.
+   */
+  double intersection_estimate(const linear_counter &other) const {
+    const double both =
+        estimate() + other.estimate() - (*this | other).estimate();
+    return both > 0 ? both : 0;
+  }
+
+private:
+  std::size_t position(const Key &key) const {
+    const std::uint64_t hash =
+        bit_word::mix(static_cast<std::uint64_t>(hasher_(key)));
+    const std::uint64_t size = bits_.size();
+    if (size > 0xFFFFFFFFULL)
+      return static_cast<std::size_t>(hash % size);
+    return static_cast<std::size_t>(((hash >> 32) * size) >> 32);
+  }
+
+  word_bitset bits_;
+  Hasher hasher_;
+};
+
+#endif
@@ -0,0 +1,458 @@
+#ifndef MORTON_H_
+#define MORTON_H_
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bit_extract.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Morton (Z-order) codes. Coordinate k of a point in D dimensions
+ * owns the code bits k, k + D, k + 2D, ..., so nearby points get nearby
+ * codes and every aligned square or cube of cells is one code range.
+ *
+ * Spreading and compacting use pdep and pext with BMI2 and the magic number
+ * shifts otherwise.
+ */
+namespace morton {
+using word_type = bit_word::word_type;
+
+/**
+ * @brief Spread the low 32 bits of x to the even bits of a word.
+ */
+inline word_type spread2(word_type x) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return bit_extract::deposit(x, 0x5555555555555555ULL);
+#else
+  x &= 0xFFFFFFFFULL;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  return (x | (x << 1)) & 0x5555555555555555ULL;
+#endif
+}
+
+/**
+ * @brief Gather the even bits of a word into the low 32 bits, the inverse of
+ * spread2.
+ */
+inline word_type compact2(word_type x) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return bit_extract::extract(x, 0x5555555555555555ULL);
+#else
+  x &= 0x5555555555555555ULL;
+  x = (x | (x >> 1)) & 0x3333333333333333ULL;
+  x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+  return (x | (x >> 16)) & 0xFFFFFFFFULL;
+#endif
+}
+
+/**
+ * @brief Spread the low 21 bits of x to every third bit of a word.
+ */
+inline word_type spread3(word_type x) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return bit_extract::deposit(x, 0x1249249249249249ULL);
+#else
+  x &= 0x1FFFFFULL;
+  x = (x | (x << 32)) & 0x001F00000000FFFFULL;
+  x = (x | (x << 16)) & 0x001F0000FF0000FFULL;
+  x = (x | (x << 8)) & 0x100F00F00F00F00FULL;
+  x = (x | (x << 4)) & 0x10C30C30C30C30C3ULL;
+  return (x | (x << 2)) & 0x1249249249249249ULL;
+#endif
+}
+
+/**
+ * @brief Gather every third bit of a word into the low 21 bits, the inverse
+ * of spread3.
+ */
+inline word_type compact3(word_type x) {
+#if defined(__BMI2__) && !defined(DYNAMIC_BITSET_PORTABLE_PDEP)
+  return bit_extract::extract(x, 0x1249249249249249ULL);
+#else
+  x &= 0x1249249249249249ULL;
+  x = (x | (x >> 2)) & 0x10C30C30C30C30C3ULL;
+  x = (x | (x >> 4)) & 0x100F00F00F00F00FULL;
+  x = (x | (x >> 8)) & 0x001F0000FF0000FFULL;
+  x = (x | (x >> 16)) & 0x001F00000000FFFFULL;
+  return (x | (x >> 32)) & 0x1FFFFFULL;
+#endif
+}
+
+/**
+ * @brief Morton code of a 2D point.
+ * @param x Coordinate below 2^32.
+ * @param y Coordinate below 2^32.
+ */
+inline word_type encode(word_type x, word_type y) {
+  return spread2(x) | (spread2(y) << 1);
+}
+
+/**
+ * @brief Morton code of a 3D point.
+ * @param x Coordinate below 2^21.
+ * @param y Coordinate below 2^21.
+ * @param z Coordinate below 2^21.
+ */
+inline word_type encode(word_type x, word_type y, word_type z) {
+  return spread3(x) | (spread3(y) << 1) | (spread3(z) << 2);
+}
+
+/**
+ * @brief Coordinates of a 2D Morton code.
+ */
+inline void decode(word_type code, word_type &x, word_type &y) {
+  x = compact2(code);
+  y = compact2(code >> 1);
+}
+
+/**
+ * @brief Coordinates of a 3D Morton code.
+ */
+inline void decode(word_type code, word_type &x, word_type &y, word_type &z) {
+  x = compact3(code);
+  y = compact3(code >> 1);
+  z = compact3(code >> 2);
+}
+
+/**
+ * @brief Read count < 64 bits starting at bit position, bits past size read
+ * as zero.
+ */
+inline word_type read_bits(const word_bitset &set, std::size_t position,
+                           std::size_t count) {
+  if (position >= set.size())
+    return 0;
+  const std::size_t index = position / bit_word::bits;
+  const std::size_t shift = position % bit_word::bits;
+  word_type bits = set.data()[index] >> shift;
+  if (shift && index + 1 < set.word_count())
+    bits |= set.data()[index + 1] << (bit_word::bits - shift);
+  return bits & bit_word::low_mask(count);
+}
+
+/**
+ * @brief Or count < 64 bits into bit position, bits past size are dropped.
+ */
+inline void or_bits(word_bitset &set, std::size_t position, word_type bits,
+                    std::size_t count) {
+  const std::size_t index = position / bit_word::bits;
+  const std::size_t shift = position % bit_word::bits;
+  set.data()[index] |= bits << shift;
+  if (shift + count > bit_word::bits && index + 1 < set.word_count())
+    set.data()[index + 1] |= bits >> (bit_word::bits - shift);
+}
+} // namespace morton
+
+/**
+ * @brief Interleave two bitsets, bit i of x goes to bit 2i and bit i of y to
+ * bit 2i + 1. Every 32 bits of x and y make one output word.
+ *
+ * @return New word_bitset of twice the size of x.
+ */
+inline word_bitset interleave(const word_bitset &x, const word_bitset &y) {
+  if (x.size() != y.size())
+    throw std::invalid_argument("interleave needs bitsets of equal size");
+  word_bitset result(2 * x.size());
+  for (std::size_t w = 0; w < result.word_count(); ++w) {
+    const std::size_t position = w * bit_word::bits / 2;
+    result.data()[w] = morton::encode(morton::read_bits(x, position, 32),
+                                      morton::read_bits(y, position, 32));
+  }
+  return result;
+}
+
+/**
+ * @brief Interleave three bitsets, bit i of x, y and z goes to bit 3i, 3i + 1
+ * and 3i + 2. Every 21 bits of the inputs make 63 output bits.
+ *
+ * @return New word_bitset of three times the size of x.
+ */
+inline word_bitset interleave(const word_bitset &x, const word_bitset &y,
+                              const word_bitset &z) {
+  if (x.size() != y.size() || x.size() != z.size())
+    throw std::invalid_argument("interleave needs bitsets of equal size");
+  word_bitset result(3 * x.size());
+  for (std::size_t position = 0; position < x.size(); position += 21)
+    morton::or_bits(result, 3 * position,
+                    morton::encode(morton::read_bits(x, position, 21),
+                                   morton::read_bits(y, position, 21),
+                                   morton::read_bits(z, position, 21)),
+                    63);
+  return result;
+}
+
+/**
+ * @brief Split a bitset into its even and odd bits, the inverse of
+ * interleave(x, y).
+ *
+ * @param code Bitset of even size.
+ * @param x Receives the even bits.
+ * @param y Receives the odd bits.
+ */
+inline void deinterleave(const word_bitset &code, word_bitset &x,
+                         word_bitset &y) {
+  if (code.size() % 2)
+    throw std::invalid_argument("deinterleave needs a size divisible by 2");
+  x = word_bitset(code.size() / 2);
+  y = word_bitset(code.size() / 2);
+  for (std::size_t w = 0; w < code.word_count(); ++w) {
+    morton::word_type low, high;
+    morton::decode(code.data()[w], low, high);
+    const std::size_t position = w * bit_word::bits / 2;
+    morton::or_bits(x, position, low, 32);
+    morton::or_bits(y, position, high, 32);
+  }
+}
+
+/**
+ * @brief Split a bitset into three, the inverse of interleave(x, y, z).
+ *
+ * @param code Bitset of a size divisible by 3.
+ * @param x Receives the bits 3i.
+ * @param y Receives the bits 3i + 1.
+ * @param z Receives the bits 3i + 2.
+ */
+inline void deinterleave(const word_bitset &code, word_bitset &x,
+                         word_bitset &y, word_bitset &z) {
+  if (code.size() % 3)
+    throw std::invalid_argument("deinterleave needs a size divisible by 3");
+  const std::size_t size = code.size() / 3;
+  x = word_bitset(size);
+  y = word_bitset(size);
+  z = word_bitset(size);
+  for (std::size_t position = 0; position < size; position += 21) {
+    morton::word_type a, b, c;
+    morton::decode(morton::read_bits(code, 3 * position, 63), a, b, c);
+    morton::or_bits(x, position, a, 21);
+    morton::or_bits(y, position, b, 21);
+    morton::or_bits(z, position, c, 21);
+  }
+}
+
+/**
+ * @brief Interleave two dynamic_bitsets, see interleave(const word_bitset &,
+ * const word_bitset &).
+ * @return New dynamic_bitset of twice the size of x.
+ */
+template <std::size_t N>
+dynamic_bitset<> interleave(const dynamic_bitset<N> &x,
+                            const dynamic_bitset<N> &y) {
+  return interleave(word_bitset(x), word_bitset(y)).to_dynamic_bitset();
+}
+
+/**
+ * @brief Interleave three dynamic_bitsets, see interleave(const word_bitset
+ * &, const word_bitset &, const word_bitset &).
+ * @return New dynamic_bitset of three times the size of x.
+ */
+template <std::size_t N>
+dynamic_bitset<> interleave(const dynamic_bitset<N> &x,
+                            const dynamic_bitset<N> &y,
+                            const dynamic_bitset<N> &z) {
+  return interleave(word_bitset(x), word_bitset(y), word_bitset(z))
+      .to_dynamic_bitset();
+}
+
+/**
+ * @brief A D dimensional occupancy grid of side^D cells stored in Morton
+ * order, D being 2 or 3.
+ *
+ * Boxes are half open, [lo[k], hi[k]) on axis k. A box query splits the box
+ * into the largest aligned squares or cubes that it contains, quadtree or
+ * octree style, and each of those is a single Morton range, so counting,
+ * filling and searching a box are range operations on the words.
+ */
+template <std::size_t D> class spatial_bitset {
+  static_assert(D == 2 || D == 3, "spatial_bitset supports 2 or 3 dimensions");
+
+public:
+  using point = std::array<std::uint32_t, D>;
+
+  /**
+   * @brief Constructor that creates an empty grid.
+   * @param side Cells per axis, rounded up to a power of two.
+   */
+  explicit spatial_bitset(std::size_t side) : levels_(0) {
+    while ((std::size_t(1) << levels_) < side)
+      ++levels_;
+    if (levels_ * D >= bit_word::bits)
+      throw std::invalid_argument("spatial_bitset side is too large");
+    cells_ = word_bitset(std::size_t(1) << (levels_ * D));
+  }
+
+  /**
+   * @brief Return amount of cells per axis
+   * @return Side of the grid
+   */
+  std::size_t side() const { return std::size_t(1) << levels_; }
+
+  /**
+   * @brief Return amount of cells
+   * @return side()^D
+   */
+  std::size_t size() const { return cells_.size(); }
+
+  /**
+   * @brief Access the cells.
+   * @return Bitset with bit code set when the cell of that Morton code is.
+   */
+  const word_bitset &bits() const { return cells_; }
+
+  /**
+   * @brief Morton code of a cell.
+   */
+  static std::size_t code(const point &p) { return encode(p); }
+
+  /**
+   * @brief Cell of a Morton code.
+   */
+  static point cell(std::size_t morton_code) { return decode(morton_code); }
+
+  /**
+   * @brief Get the value of a cell.
+   */
+  bool test(const point &p) const { return cells_.test(encode(p)); }
+
+  /**
+   * @brief Set the value of a cell.
+   * @return Return object itself
+   */
+  spatial_bitset &set(const point &p, bool value) {
+    cells_.set(encode(p), value);
+    return *this;
+  }
+
+  /**
+   * @brief Set the value of every cell of a box.
+   * @return Return object itself
+   */
+  spatial_bitset &set(const point &lo, const point &hi, bool value) {
+    for (const auto &range : ranges(lo, hi))
+      cells_.set_range(range.first, range.second, value);
+    return *this;
+  }
+
+  /**
+   * @brief Number of set cells
+   * @return Population count of the grid
+   */
+  std::size_t count() const { return cells_.count(); }
+
+  /**
+   * @brief Number of set cells of a box.
+   */
+  std::size_t count(const point &lo, const point &hi) const {
+    std::size_t total = 0;
+    for (const auto &range : ranges(lo, hi))
+      total += cells_.count_range(range.first, range.second);
+    return total;
+  }
+
+  /**
+   * @brief Check if any cell of a box is set.
+   */
+  bool any(const point &lo, const point &hi) const {
+    for (const auto &range : ranges(lo, hi))
+      if (first_set(range.first) < range.second)
+        return true;
+    return false;
+  }
+
+  /**
+   * @brief Call function with every set cell of a box, in Morton order.
+   */
+  template <typename Function>
+  void for_each(const point &lo, const point &hi, Function function) const {
+    for (const auto &range : ranges(lo, hi))
+      for (std::size_t c = first_set(range.first); c < range.second;
+           c = cells_.find_next(c))
+        function(decode(c));
+  }
+
+  /**
+   * @brief Morton ranges covering a box.
+   * @return Sorted, disjoint and non adjacent [first, last) code ranges.
+   */
+  std::vector<std::pair<std::size_t, std::size_t>>
+  ranges(const point &lo, const point &hi) const {
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    point origin;
+    origin.fill(0);
+    collect(origin, levels_, lo, hi, result);
+    return result;
+  }
+
+private:
+  static std::size_t encode(const std::array<std::uint32_t, 2> &p) {
+    return morton::encode(p[0], p[1]);
+  }
+
+  static std::size_t encode(const std::array<std::uint32_t, 3> &p) {
+    return morton::encode(p[0], p[1], p[2]);
+  }
+
+  static point decode(std::size_t morton_code) {
+    morton::word_type coordinates[3];
+    if (D == 2)
+      morton::decode(morton_code, coordinates[0], coordinates[1]);
+    else
+      morton::decode(morton_code, coordinates[0], coordinates[1],
+                     coordinates[2]);
+    point p;
+    for (std::size_t k = 0; k < D; ++k)
+      p[k] = static_cast<std::uint32_t>(coordinates[k]);
+    return p;
+  }
+
+  std::size_t first_set(std::size_t position) const {
+    return position == 0 ? cells_.find_first() : cells_.find_next(position - 1);
+  }
+
+  /**
+   * @brief Add the ranges of the part of the box inside the cell of side
+   * 2^level at origin, children are visited in Morton order.
+   */
+  void collect(const point &origin, unsigned level, const point &lo,
+               const point &hi,
+               std::vector<std::pair<std::size_t, std::size_t>> &out) const {
+    const std::size_t extent = std::size_t(1) << level;
+    bool inside = true;
+    for (std::size_t k = 0; k < D; ++k) {
+      if (origin[k] >= hi[k] || origin[k] + extent <= lo[k])
+        return;
+      inside = inside && lo[k] <= origin[k] && origin[k] + extent <= hi[k];
+    }
+    if (inside) {
+      const std::size_t first = encode(origin);
+      const std::size_t last = first + (std::size_t(1) << (level * D));
+      if (!out.empty() && out.back().second == first)
+        out.back().second = last;
+      else
+        out.emplace_back(first, last);
+      return;
+    }
+    const std::uint32_t half = static_cast<std::uint32_t>(extent / 2);
+    for (std::size_t child = 0; child < (std::size_t(1) << D); ++child) {
+      point corner = origin;
+      for (std::size_t k = 0; k < D; ++k)
+        if ((child >> k) & 1)
+          corner[k] += half;
+      collect(corner, level - 1, lo, hi, out);
+    }
+  }
+
+  unsigned levels_;
+  word_bitset cells_;
+};
+
+#endif
@@ -0,0 +1,428 @@
+#ifndef PERSISTENT_BITSET_H_
+#define PERSISTENT_BITSET_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tracked_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief File helpers of persistent_bitset. Files hold 64 bit words in the
+ * byte order of the host.
+ */
+namespace persistent_io {
+using word_type = bit_word::word_type;
+
+/// First word of an image file.
+constexpr word_type image_magic = 0x3154455354494244ULL; // "DBITSET1"
+
+/**
+ * @brief Open a file, throwing when that fails.
+ */
+inline std::FILE *open(const std::string &path, const char *mode) {
+  std::FILE *file = std::fopen(path.c_str(), mode);
+  if (!file)
+    throw std::runtime_error("cannot open " + path);
+  return file;
+}
+
+/**
+ * @brief Write words, throwing when that fails.
+ */
+inline void write(std::FILE *file, const word_type *words, std::size_t count) {
+  if (count && std::fwrite(words, sizeof(word_type), count, file) != count)
+    throw std::runtime_error("persistent_bitset write failed");
+}
+
+/**
+ * @brief Read words.
+ * @return False if the file ended first.
+ */
+inline bool read(std::FILE *file, word_type *words, std::size_t count) {
+  return !count || std::fread(words, sizeof(word_type), count, file) == count;
+}
+
+/**
+ * @brief Flush the buffers of a file and wait until the data is on disk.
+ */
+inline void sync(std::FILE *file) {
+  if (std::fflush(file) != 0)
+    throw std::runtime_error("persistent_bitset flush failed");
+#if defined(_WIN32)
+  const int result = _commit(_fileno(file));
+#else
+  const int result = fsync(fileno(file));
+#endif
+  if (result != 0)
+    throw std::runtime_error("persistent_bitset sync failed");
+}
+
+/**
+ * @brief Sync the directory holding path, so a newly created file survives a
+ * power loss. Windows has no directory sync, there it does nothing.
+ */
+inline void sync_directory(const std::string &path) {
+#if !defined(_WIN32)
+  const std::size_t slash = path.find_last_of('/');
+  std::string directory = ".";
+  if (slash != std::string::npos)
+    directory = slash == 0 ? "/" : path.substr(0, slash);
+  const int descriptor = ::open(directory.c_str(), O_RDONLY);
+  if (descriptor < 0)
+    throw std::runtime_error("cannot open " + directory);
+  const int result = fsync(descriptor);
+  ::close(descriptor);
+  if (result != 0)
+    throw std::runtime_error("persistent_bitset directory sync failed");
+#else
+  (void)path;
+#endif
+}
+
+/**
+ * @brief Move to a byte offset from the start of a file, 64 bit on every
+ * platform.
+ */
+inline void seek(std::FILE *file, std::uint64_t offset) {
+#if defined(_WIN32)
+  const int result = _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#else
+  const int result = fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+  if (result != 0)
+    throw std::runtime_error("persistent_bitset seek failed");
+}
+
+/**
+ * @brief Cut a file to bytes and sync it.
+ */
+inline void truncate(std::FILE *file, std::size_t bytes) {
+  if (std::fflush(file) != 0)
+    throw std::runtime_error("persistent_bitset flush failed");
+  std::clearerr(file);
+#if defined(_WIN32)
+  const int result = _chsize_s(_fileno(file), static_cast<__int64>(bytes));
+#else
+  const int result = ftruncate(fileno(file), static_cast<off_t>(bytes));
+#endif
+  if (result != 0)
+    throw std::runtime_error("persistent_bitset truncate failed");
+  sync(file);
+}
+
+/**
+ * @brief Checksum of a log batch.
+ */
+inline word_type checksum(const word_type *words, std::size_t count) {
+  word_type hash = count;
+  for (std::size_t i = 0; i < count; ++i)
+    hash = bit_word::mix(hash ^ words[i]);
+  return hash;
+}
+} // namespace persistent_io
+
+/**
+ * @brief A bitset backed by an image file and a write-ahead log.
+ *
+ * Updates change the bitset in memory at once and are queued as
+ * (operation, first, last) records. commit() appends the queued records to
+ * the log as one batch with a count and a checksum and syncs the log once,
+ * so a whole group of updates costs a single sync (group commit). A commit
+ * also happens by itself once group_size records are queued.
+ *
+ * checkpoint() writes only the words changed since the last checkpoint into
+ * the image, syncs it and then empties the log. Replaying a record yields the
+ * same bits whatever the image held before, so a crash at any point leaves
+ * the image plus the log describing every committed update. Opening an
+ * existing image replays the log up to the first short or damaged batch,
+ * the one cut off by a crash, and checkpoints the result.
+ */
+class persistent_bitset {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that opens or creates a persistent bitset.
+   *
+   * @param path Image file, the log is path + ".log".
+   * @param size Amount of bits, must match an existing image.
+   * @param group_size Queued records that trigger a commit.
+   * @param checkpoint_bytes Log size that triggers a checkpoint.
+   */
+  persistent_bitset(const std::string &path, std::size_t size,
+                    std::size_t group_size = 4096,
+                    std::size_t checkpoint_bytes = std::size_t(64) << 20)
+      : path_(path), log_path_(path + ".log"), bits_(size),
+        group_size_(group_size), checkpoint_bytes_(checkpoint_bytes) {
+    std::FILE *existing = std::fopen(path_.c_str(), "rb");
+    if (existing) {
+      try {
+        load(existing);
+      } catch (...) {
+        std::fclose(existing);
+        throw;
+      }
+      std::fclose(existing);
+    }
+    try {
+      if (existing)
+        image_ = persistent_io::open(path_, "r+b");
+      else
+        create();
+      replay();
+      log_ = persistent_io::open(log_path_, "ab");
+      // unbuffered, so a failed append leaves nothing behind to flush later
+      std::setvbuf(log_, nullptr, _IONBF, 0);
+      // the entries of a new image or log must be durable before any commit
+      persistent_io::sync_directory(path_);
+      checkpoint();
+    } catch (...) {
+      close();
+      throw;
+    }
+  }
+
+  persistent_bitset(const persistent_bitset &) = delete;
+  persistent_bitset &operator=(const persistent_bitset &) = delete;
+
+  /**
+   * @brief Destructor that commits the queued records.
+   */
+  ~persistent_bitset() {
+    try {
+      commit();
+    } catch (...) {
+    }
+    close();
+  }
+
+  /**
+   * @brief Return amount of bits
+   * @return Amount of bits
+   */
+  std::size_t size() const { return bits_.size(); }
+
+  /**
+   * @brief Access the current bits, committed or not.
+   */
+  const word_bitset &bits() const { return bits_.bits(); }
+
+  /**
+   * @brief Get the value of a bit.
+   */
+  bool test(std::size_t index) const { return bits_.test(index); }
+
+  /**
+   * @brief Number of set bits
+   * @return Population count of the bitset
+   */
+  std::size_t count() const { return bits_.count(); }
+
+  /**
+   * @brief Amount of records waiting for the next commit.
+   */
+  std::size_t pending() const { return pending_.size() / 3; }
+
+  /**
+   * @brief Amount of bytes in the log.
+   */
+  std::size_t log_bytes() const { return log_bytes_; }
+
+  /**
+   * @brief Set the value of a bit.
+   * @return Return object itself
+   */
+  persistent_bitset &set(std::size_t index, bool value = true) {
+    return set_range(index, index + 1, value);
+  }
+
+  /**
+   * @brief Set a bit to false.
+   * @return Return object itself
+   */
+  persistent_bitset &reset(std::size_t index) {
+    return set_range(index, index + 1, false);
+  }
+
+  /**
+   * @brief Set the bits in [first, last) to the given value.
+   * @return Return object itself
+   */
+  persistent_bitset &set_range(std::size_t first, std::size_t last,
+                               bool value) {
+    if (last > size())
+      throw std::out_of_range("persistent_bitset range is out of range");
+    if (first >= last)
+      return *this;
+    bits_.set_range(first, last, value);
+    pending_.push_back(value);
+    pending_.push_back(first);
+    pending_.push_back(last);
+    if (pending() >= group_size_)
+      commit();
+    return *this;
+  }
+
+  /**
+   * @brief Make the queued records durable with one log append and one sync.
+   *
+   * A failed append is cut off the log again and the records stay queued, so
+   * commit() can be retried. If the log cannot be cut back, later commits
+   * throw instead of appending behind the damaged batch, which replay would
+   * never reach.
+   *
+   * @return Return object itself
+   */
+  persistent_bitset &commit() {
+    if (pending_.empty())
+      return *this;
+    if (broken_)
+      throw std::runtime_error("persistent_bitset log is damaged");
+    const word_type header[2] = {
+        pending_.size(),
+        persistent_io::checksum(pending_.data(), pending_.size())};
+    try {
+      persistent_io::write(log_, header, 2);
+      persistent_io::write(log_, pending_.data(), pending_.size());
+      persistent_io::sync(log_);
+    } catch (...) {
+      try {
+        persistent_io::truncate(log_, log_bytes_);
+      } catch (...) {
+        broken_ = true;
+      }
+      throw;
+    }
+    log_bytes_ += sizeof(word_type) * (2 + pending_.size());
+    pending_.clear();
+    if (log_bytes_ >= checkpoint_bytes_)
+      checkpoint();
+    return *this;
+  }
+
+  /**
+   * @brief Commit, write the changed words into the image and empty the log.
+   * @return Return object itself
+   */
+  persistent_bitset &checkpoint() {
+    commit();
+    // runs closer than a page are written as one, the clean words between
+    // them are rewritten unchanged, which saves a seek per run
+    const std::size_t gap = 512;
+    const word_type *words = bits_.bits().data();
+    std::size_t first = 0, last = 0;
+    auto flush = [&] {
+      persistent_io::seek(image_,
+                          (2 + std::uint64_t(first)) * sizeof(word_type));
+      persistent_io::write(image_, words + first, last - first);
+    };
+    bits_.for_each_dirty_run([&](std::size_t run, std::size_t count) {
+      if (last != 0 && run - last <= gap) {
+        last = run + count;
+        return;
+      }
+      if (last != 0)
+        flush();
+      first = run;
+      last = run + count;
+    });
+    if (last != 0)
+      flush();
+    persistent_io::sync(image_);
+    bits_.mark_clean();
+    // the image holds every committed update, the log can go
+    persistent_io::truncate(log_, 0);
+    log_bytes_ = 0;
+    return *this;
+  }
+
+private:
+  void close() {
+    if (log_)
+      std::fclose(log_);
+    if (image_)
+      std::fclose(image_);
+    log_ = image_ = nullptr;
+  }
+
+  void load(std::FILE *file) {
+    word_type header[2];
+    if (!persistent_io::read(file, header, 2) ||
+        header[0] != persistent_io::image_magic)
+      throw std::runtime_error(path_ + " is not a persistent_bitset image");
+    if (header[1] != size())
+      throw std::invalid_argument(path_ + " holds a bitset of another size");
+    word_bitset image(size());
+    if (!persistent_io::read(file, image.data(), image.word_count()))
+      throw std::runtime_error(path_ + " is truncated");
+    image.trim();
+    bits_ = tracked_bitset(image);
+  }
+
+  void create() {
+    image_ = persistent_io::open(path_, "w+b");
+    const word_type header[2] = {persistent_io::image_magic, size()};
+    persistent_io::write(image_, header, 2);
+    persistent_io::write(image_, bits_.bits().data(),
+                         bits_.bits().word_count());
+    persistent_io::sync(image_);
+  }
+
+  /**
+   * @brief Apply the complete batches of the log.
+   */
+  void replay() {
+    std::FILE *log = std::fopen(log_path_.c_str(), "rb");
+    if (!log)
+      return;
+    std::fseek(log, 0, SEEK_END);
+    const std::size_t words = static_cast<std::size_t>(std::ftell(log)) /
+                              sizeof(word_type);
+    std::fseek(log, 0, SEEK_SET);
+    std::vector<word_type> records;
+    word_type header[2];
+    for (std::size_t position = 2; position <= words;
+         position += 2 + records.size()) {
+      // a batch that does not fit into the rest of the log is cut off
+      if (!persistent_io::read(log, header, 2) || header[0] % 3 ||
+          header[0] > words - position)
+        break;
+      records.resize(header[0]);
+      if (!persistent_io::read(log, records.data(), records.size()) ||
+          persistent_io::checksum(records.data(), records.size()) != header[1])
+        break;
+      for (std::size_t i = 0; i < records.size(); i += 3)
+        if (records[i + 1] < records[i + 2] && records[i + 2] <= size())
+          bits_.set_range(records[i + 1], records[i + 2], records[i] != 0);
+    }
+    std::fclose(log);
+  }
+
+  std::string path_;
+  std::string log_path_;
+  /// Current bits, dirty words are not in the image yet.
+  tracked_bitset bits_;
+  /// Queued records, (value, first, last) each.
+  std::vector<word_type> pending_;
+  std::size_t group_size_;
+  std::size_t checkpoint_bytes_;
+  std::size_t log_bytes_ = 0;
+  /// Set when a failed append could not be cut off the log.
+  bool broken_ = false;
+  std::FILE *image_ = nullptr;
+  std::FILE *log_ = nullptr;
+};
+
+#endif
@@ -0,0 +1,544 @@
+#ifndef POSTING_ENGINE_H_
+#define POSTING_ENGINE_H_
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief A boolean query tree over the terms of a posting_engine.
+ *
+ * Leaves refer to terms by the id returned from posting_engine::add_term,
+ * inner nodes combine their children with AND, OR or NOT. The operators &, |
+ * and ~ build the same trees and flatten chains of the same kind.
+ */
+class posting_query {
+public:
+  /**
+   * @brief Type of a query node.
+   */
+  enum class kind { term, all_of, any_of, negate };
+
+  /**
+   * @brief Leaf matching the documents of a term.
+   * @param id Term id returned by posting_engine::add_term.
+   * @return New query
+   */
+  static posting_query term(std::size_t id) {
+    return posting_query(kind::term, id, {});
+  }
+
+  /**
+   * @brief Documents matching every child (AND).
+   * @return New query
+   */
+  static posting_query all_of(std::vector<posting_query> children) {
+    return posting_query(kind::all_of, 0, std::move(children));
+  }
+
+  /**
+   * @brief Documents matching any child (OR).
+   * @return New query
+   */
+  static posting_query any_of(std::vector<posting_query> children) {
+    return posting_query(kind::any_of, 0, std::move(children));
+  }
+
+  /**
+   * @brief Documents not matching child (NOT).
+   * @return New query
+   */
+  static posting_query negate(posting_query child) {
+    return posting_query(kind::negate, 0, {std::move(child)});
+  }
+
+  /**
+   * @brief Return type of the node
+   * @return kind of the node
+   */
+  kind type() const { return kind_; }
+
+  /**
+   * @brief Return term id of a leaf
+   * @return Term id
+   */
+  std::size_t term_id() const { return term_; }
+
+  /**
+   * @brief Return children of an inner node
+   * @return Children of the node
+   */
+  const std::vector<posting_query> &children() const { return children_; }
+
+  /**
+   * @brief and operator between two queries
+   * @return New query
+   */
+  posting_query operator&(const posting_query &other) const {
+    return combine(kind::all_of, other);
+  }
+
+  /**
+   * @brief or operator between two queries
+   * @return New query
+   */
+  posting_query operator|(const posting_query &other) const {
+    return combine(kind::any_of, other);
+  }
+
+  /**
+   * @brief not operator of a query
+   * @return New query
+   */
+  posting_query operator~() const {
+    if (kind_ == kind::negate)
+      return children_.front();
+    return negate(*this);
+  }
+
+private:
+  posting_query(kind type, std::size_t term, std::vector<posting_query> children)
+      : kind_(type), term_(term), children_(std::move(children)) {}
+
+  /**
+   * @brief Join two queries under a node of type, flattening nodes of the same
+   * type.
+   */
+  posting_query combine(kind type, const posting_query &other) const {
+    std::vector<posting_query> children;
+    for (const auto *query : {this, &other}) {
+      if (query->kind_ == type)
+        children.insert(children.end(), query->children_.begin(),
+                        query->children_.end());
+      else
+        children.push_back(*query);
+    }
+    return posting_query(type, 0, std::move(children));
+  }
+
+  kind kind_;
+  std::size_t term_;
+  std::vector<posting_query> children_;
+};
+
+/**
+ * @brief Evaluates posting_query trees over one bitset per term.
+ *
+ * Every term keeps its postings as packed bits; terms that match fewer
+ * documents than the bitmap has words additionally keep a sorted list of
+ * document ids. The planner estimates the matches of every child once per
+ * evaluation: terms use their exact frequency, other subtrees are evaluated
+ * only on a stratified sample of at most 1 / sample_share of the words (see
+ * bit_word::sampled_popcount). Indexes too small for a useful sample bound
+ * the matches from the estimates of the children instead. AND nodes are
+ * evaluated cheapest child first:
+ *  - when the cheapest child is expected to be sparse, the candidates stay a
+ *    document list that is galloped against other sparse terms and probed
+ *    against dense ones,
+ *  - otherwise a single accumulator is and-ed in place.
+ * Evaluation stops as soon as an intermediate result of an AND is empty, or
+ * the accumulator of an OR is full.
+ */
+class posting_engine {
+public:
+  using word_type = bit_word::word_type;
+
+  /// Sampled estimates read at most this fraction of the words.
+  static constexpr std::size_t sample_share = 16;
+
+  /// Fewer samples than this make an estimate fall back to a bound.
+  static constexpr std::size_t min_samples = 256;
+
+  /**
+   * @brief Constructor that creates an engine without terms.
+   *
+   * @param documents Amount of documents, the size of every posting bitset.
+   * @param estimate_error Allowed error of sampled estimates as a fraction of
+   * documents.
+   */
+  explicit posting_engine(std::size_t documents, double estimate_error = 0.01)
+      : documents_(documents), estimate_error_(estimate_error) {}
+
+  /**
+   * @brief Add the postings of a term.
+   * @param postings Bit i is set if the term occurs in document i.
+   * @return Id of the term.
+   */
+  template <std::size_t N>
+  std::size_t add_term(const dynamic_bitset<N> &postings) {
+    return add_term(word_bitset(postings));
+  }
+
+  /**
+   * @brief Add the postings of a term.
+   * @param postings Bit i is set if the term occurs in document i.
+   * @return Id of the term.
+   */
+  std::size_t add_term(word_bitset postings) {
+    postings.resize(documents_);
+    posting entry;
+    entry.frequency = postings.count();
+    if (entry.frequency <= postings.word_count())
+      postings.for_each([&entry](std::size_t i) { entry.list.push_back(i); });
+    entry.bits = std::move(postings);
+    terms_.push_back(std::move(entry));
+    return terms_.size() - 1;
+  }
+
+  /**
+   * @brief Return amount of documents
+   * @return Amount of documents
+   */
+  std::size_t documents() const { return documents_; }
+
+  /**
+   * @brief Return amount of terms
+   * @return Amount of terms
+   */
+  std::size_t term_count() const { return terms_.size(); }
+
+  /**
+   * @brief Amount of documents that contain a term.
+   * @param id Term id.
+   * @return Document frequency of the term.
+   */
+  std::size_t frequency(std::size_t id) const { return terms_[id].frequency; }
+
+  /**
+   * @brief Return allowed error of sampled estimates
+   * @return Error as a fraction of documents
+   */
+  double estimate_error() const { return estimate_error_; }
+
+  /**
+   * @brief Estimate the matches of a query without evaluating it.
+   *
+   * Terms return their exact frequency. Other queries are evaluated on a
+   * sample of words only, so the cost depends on estimate_error() and not on
+   * the amount of documents. When the sample would need more than
+   * 1 / sample_share of the words, the matches are bounded from the children
+   * instead: the smallest child of an AND, the sum of the children of an OR.
+   *
+   * @return Estimated amount of matching documents.
+   */
+  std::size_t estimate(const posting_query &query) const {
+    estimates cache;
+    return estimate(query, cache);
+  }
+
+  /**
+   * @brief Evaluate a query.
+   * @return dynamic_bitset of matching documents.
+   */
+  dynamic_bitset<> evaluate(const posting_query &query) const {
+    return evaluate_words(query).to_dynamic_bitset();
+  }
+
+  /**
+   * @brief Evaluate a query.
+   * @return Packed bits of matching documents.
+   */
+  word_bitset evaluate_words(const posting_query &query) const {
+    estimates cache;
+    return evaluate_node(query, cache);
+  }
+
+private:
+  /**
+   * @brief Postings of a single term.
+   */
+  struct posting {
+    word_bitset bits;
+    std::vector<std::size_t> list;
+    std::size_t frequency = 0;
+  };
+
+  using plan = std::vector<std::pair<std::size_t, const posting_query *>>;
+
+  /// Estimates of the inner nodes of the query being evaluated.
+  using estimates = std::unordered_map<const posting_query *, std::size_t>;
+
+  /**
+   * @brief Estimate the matches of a node, every inner node once per cache.
+   */
+  std::size_t estimate(const posting_query &query, estimates &cache) const {
+    if (query.type() == posting_query::kind::term)
+      return terms_[query.term_id()].frequency;
+    const auto found = cache.find(&query);
+    if (found != cache.end())
+      return found->second;
+    const std::size_t words = bit_word::words_for(documents_);
+    const std::size_t samples =
+        std::min(bit_word::sample_size(estimate_error_), words / sample_share);
+    std::size_t result;
+    if (samples >= min_samples)
+      result = std::min(documents_, bit_word::sampled_popcount(
+                                        words, samples,
+                                        [this, &query](std::size_t w) {
+                                          return evaluate_word(query, w);
+                                        }));
+    else
+      result = bound(query, cache);
+    cache.emplace(&query, result);
+    return result;
+  }
+
+  /**
+   * @brief Estimate the matches of an inner node from its children.
+   */
+  std::size_t bound(const posting_query &query, estimates &cache) const {
+    const auto &children = query.children();
+    switch (query.type()) {
+    case posting_query::kind::negate:
+      return documents_ - std::min(documents_, estimate(children[0], cache));
+    case posting_query::kind::any_of: {
+      // an upper bound, so an OR never stops early on a low guess
+      std::size_t total = 0;
+      for (const auto &child : children)
+        total = std::min(documents_, total + estimate(child, cache));
+      return total;
+    }
+    case posting_query::kind::all_of:
+    default: {
+      std::size_t smallest = documents_;
+      for (const auto &child : children)
+        smallest = std::min(smallest, estimate(child, cache));
+      return smallest;
+    }
+    }
+  }
+
+  /**
+   * @brief Evaluate a node, reusing the estimates of cache.
+   */
+  word_bitset evaluate_node(const posting_query &query,
+                            estimates &cache) const {
+    switch (query.type()) {
+    case posting_query::kind::term:
+      return terms_[query.term_id()].bits;
+    case posting_query::kind::negate:
+      return evaluate_node(query.children()[0], cache).flip();
+    case posting_query::kind::any_of:
+      return evaluate_any_of(query, cache);
+    case posting_query::kind::all_of:
+    default:
+      return evaluate_all_of(query, cache);
+    }
+  }
+
+  /**
+   * @brief Order children by estimated matches.
+   */
+  plan order_by_estimate(const std::vector<const posting_query *> &children,
+                         bool descending, estimates &cache) const {
+    plan order;
+    for (const auto *child : children)
+      order.emplace_back(estimate(*child, cache), child);
+    std::stable_sort(order.begin(), order.end(),
+                     [descending](const plan::value_type &a,
+                                  const plan::value_type &b) {
+                       return descending ? a.first > b.first
+                                         : a.first < b.first;
+                     });
+    return order;
+  }
+
+  /**
+   * @brief Compute a single word of the result of a query.
+   */
+  word_type evaluate_word(const posting_query &query, std::size_t w) const {
+    const word_type valid =
+        w + 1 == bit_word::words_for(documents_)
+            ? bit_word::low_mask(documents_ - w * bit_word::bits)
+            : ~word_type(0);
+    switch (query.type()) {
+    case posting_query::kind::term:
+      return terms_[query.term_id()].bits.data()[w];
+    case posting_query::kind::negate:
+      return ~evaluate_word(query.children()[0], w) & valid;
+    case posting_query::kind::any_of: {
+      word_type word = 0;
+      for (const auto &child : query.children())
+        word |= evaluate_word(child, w);
+      return word;
+    }
+    case posting_query::kind::all_of:
+    default: {
+      word_type word = valid;
+      for (const auto &child : query.children())
+        word &= evaluate_word(child, w);
+      return word;
+    }
+    }
+  }
+
+  /**
+   * @brief Evaluate an OR node, largest child first, stopping once every
+   * document matches.
+   */
+  word_bitset evaluate_any_of(const posting_query &query,
+                              estimates &cache) const {
+    std::vector<const posting_query *> children;
+    for (const auto &child : query.children())
+      children.push_back(&child);
+    const plan order = order_by_estimate(children, true, cache);
+
+    word_bitset result(documents_);
+    std::size_t expected = 0;
+    for (const auto &entry : order) {
+      if (entry.second->type() == posting_query::kind::term)
+        result |= terms_[entry.second->term_id()].bits;
+      else
+        result |= evaluate_node(*entry.second, cache);
+      expected += entry.first;
+      if (expected >= documents_ && result.all())
+        return result;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Evaluate an AND node, cheapest child first.
+   */
+  word_bitset evaluate_all_of(const posting_query &query,
+                              estimates &cache) const {
+    std::vector<const posting_query *> positive;
+    std::vector<const posting_query *> negative;
+    for (const auto &child : query.children()) {
+      if (child.type() == posting_query::kind::negate)
+        negative.push_back(&child.children()[0]);
+      else
+        positive.push_back(&child);
+    }
+
+    const plan order = order_by_estimate(positive, false, cache);
+    if (!order.empty() && order.front().first == 0 &&
+        order.front().second->type() == posting_query::kind::term)
+      return word_bitset(documents_);
+    if (!order.empty() &&
+        order.front().first <= bit_word::words_for(documents_)) {
+      const posting_query &front = *order.front().second;
+      std::vector<std::size_t> candidates;
+      if (is_sparse_term(front))
+        candidates = terms_[front.term_id()].list;
+      else
+        evaluate_node(front, cache).for_each(
+            [&candidates](std::size_t d) { candidates.push_back(d); });
+      return intersect_sparse(std::move(candidates), order, negative, cache);
+    }
+
+    word_bitset result(documents_, order.empty());
+    bool first = true;
+    for (const auto &entry : order) {
+      if (first)
+        result = evaluate_node(*entry.second, cache);
+      else if (entry.second->type() == posting_query::kind::term)
+        result &= terms_[entry.second->term_id()].bits;
+      else
+        result &= evaluate_node(*entry.second, cache);
+      first = false;
+      if (result.none())
+        return result;
+    }
+    for (const auto *child : negative) {
+      if (child->type() == posting_query::kind::term)
+        result.and_not(terms_[child->term_id()].bits);
+      else
+        result.and_not(evaluate_node(*child, cache));
+      if (result.none())
+        return result;
+    }
+    return result;
+  }
+
+  /**
+   * @brief AND whose cheapest child is sparse, candidates are kept as a sorted
+   * document list.
+   */
+  word_bitset intersect_sparse(
+      std::vector<std::size_t> candidates, const plan &order,
+      const std::vector<const posting_query *> &negative,
+      estimates &cache) const {
+    for (std::size_t i = 1; i < order.size() && !candidates.empty(); ++i) {
+      const posting_query &child = *order[i].second;
+      if (is_sparse_term(child))
+        candidates = gallop_intersect(candidates, terms_[child.term_id()].list);
+      else if (child.type() == posting_query::kind::term)
+        keep_if(candidates, terms_[child.term_id()].bits, true);
+      else
+        keep_if(candidates, evaluate_node(child, cache), true);
+    }
+    for (std::size_t i = 0; i < negative.size() && !candidates.empty(); ++i) {
+      if (negative[i]->type() == posting_query::kind::term)
+        keep_if(candidates, terms_[negative[i]->term_id()].bits, false);
+      else
+        keep_if(candidates, evaluate_node(*negative[i], cache), false);
+    }
+
+    word_bitset result(documents_);
+    for (const auto document : candidates)
+      result.set(document, true);
+    return result;
+  }
+
+  /**
+   * @brief Check if a query is a term that keeps a document list.
+   */
+  bool is_sparse_term(const posting_query &query) const {
+    return query.type() == posting_query::kind::term &&
+           terms_[query.term_id()].frequency <=
+               terms_[query.term_id()].bits.word_count();
+  }
+
+  /**
+   * @brief Remove the documents whose bit is not equal to value.
+   */
+  static void keep_if(std::vector<std::size_t> &documents,
+                      const word_bitset &bits, bool value) {
+    documents.erase(std::remove_if(documents.begin(), documents.end(),
+                                   [&bits, value](std::size_t document) {
+                                     return bits.test(document) != value;
+                                   }),
+                    documents.end());
+  }
+
+  /**
+   * @brief Intersection of two sorted lists, walking the shorter one and
+   * galloping through the longer one.
+   */
+  static std::vector<std::size_t>
+  gallop_intersect(const std::vector<std::size_t> &a,
+                   const std::vector<std::size_t> &b) {
+    const auto &small = a.size() <= b.size() ? a : b;
+    const auto &large = a.size() <= b.size() ? b : a;
+    std::vector<std::size_t> result;
+    std::size_t low = 0;
+    for (const auto value : small) {
+      std::size_t step = 1;
+      std::size_t high = low;
+      while (high < large.size() && large[high] < value) {
+        low = high + 1;
+        high += step;
+        step *= 2;
+      }
+      high = std::min(high + 1, large.size());
+      low = std::lower_bound(large.begin() + low, large.begin() + high, value) -
+            large.begin();
+      if (low == large.size())
+        break;
+      if (large[low] == value)
+        result.push_back(value);
+    }
+    return result;
+  }
+
+  std::size_t documents_;
+  double estimate_error_;
+  std::vector<posting> terms_;
+};
+
+#endif
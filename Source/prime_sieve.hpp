@@ -0,0 +1,168 @@
+#ifndef PRIME_SIEVE_H_
+#define PRIME_SIEVE_H_
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "word_bitset.hpp"
+
+/**
+ * @brief Prime table up to a limit, built by an odd-only segmented Sieve of
+ * Eratosthenes.
+ *
+ * Bit i of the table stands for the odd number 2i + 1, so the table needs
+ * limit / 16 bytes and 2 is handled on the side. The table is crossed off in
+ * segments of segment_bits bits, 32 KiB that stay in the L1 cache while every
+ * base prime p resets its multiples with a set_stride pass of step p. The
+ * segments are word aligned and disjoint, so threads sieve them in parallel
+ * on the shared table without locking.
+ */
+class prime_sieve {
+public:
+  /**
+   * @brief Bits of a segment, 32 KiB.
+   */
+  static constexpr std::size_t segment_bits = 32 * 1024 * 8;
+
+  /**
+   * @brief Constructor that sieves every number up to limit.
+   *
+   * @param limit Largest number of the table.
+   * @param threads Amount of threads, 0 uses the hardware concurrency.
+   */
+  explicit prime_sieve(std::size_t limit, std::size_t threads = 1)
+      : limit_(limit), odds_(limit / 2 + (limit % 2)) {
+    if (odds_.size() == 0)
+      return;
+    odds_.set(true);
+    odds_.reset(0);
+    const std::vector<std::size_t> base = base_primes(root(limit));
+    const std::size_t segment = segment_bits;
+    const std::size_t segments = (odds_.size() + segment - 1) / segment;
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<std::size_t>(1, std::min(threads, segments));
+
+    // segments are dealt round robin, so every thread gets the same mix of
+    // dense low and sparse high segments
+    auto work = [&](std::size_t first) {
+      for (std::size_t s = first; s < segments; s += threads)
+        sieve_segment(base, s * segment,
+                      std::min(odds_.size(), (s + 1) * segment));
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t)
+      workers.emplace_back(work, t);
+    work(0);
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  /**
+   * @brief Return largest number of the table
+   * @return The limit
+   */
+  std::size_t limit() const { return limit_; }
+
+  /**
+   * @brief Check if a number is prime.
+   * @param n Number up to limit().
+   * @return True if n is prime.
+   */
+  bool is_prime(std::size_t n) const {
+    if (n % 2 == 0)
+      return n == 2;
+    return odds_.test(n / 2);
+  }
+
+  /**
+   * @brief Prime counting function by popcount of the table.
+   * @param n Number up to limit().
+   * @return Amount of primes not above n.
+   */
+  std::size_t pi(std::size_t n) const {
+    if (n < 2)
+      return 0;
+    // the odd numbers up to n are the bits [0, (n + 1) / 2)
+    return 1 + odds_.count_range(0, (n + 1) / 2);
+  }
+
+  /**
+   * @brief Amount of primes up to limit().
+   */
+  std::size_t count() const { return pi(limit_); }
+
+  /**
+   * @brief List the primes.
+   * @return Primes up to limit() in increasing order.
+   */
+  std::vector<std::size_t> primes() const {
+    std::vector<std::size_t> result;
+    if (limit_ >= 2)
+      result.push_back(2);
+    odds_.for_each([&result](std::size_t i) { result.push_back(2 * i + 1); });
+    return result;
+  }
+
+  /**
+   * @brief Access the odd table.
+   * @return Bitset with bit i set when 2i + 1 is prime.
+   */
+  const word_bitset &odds() const { return odds_; }
+
+private:
+  static std::size_t root(std::size_t n) {
+    std::size_t r = 0;
+    while ((r + 1) * (r + 1) <= n)
+      ++r;
+    return r;
+  }
+
+  /**
+   * @brief Odd primes up to limit by a plain odd-only sieve.
+   */
+  static std::vector<std::size_t> base_primes(std::size_t limit) {
+    std::vector<std::size_t> result;
+    if (limit < 3)
+      return result;
+    word_bitset odds(limit / 2 + (limit % 2), true);
+    for (std::size_t i = 1; (2 * i + 1) * (2 * i + 1) <= limit; ++i)
+      if (odds.test(i))
+        odds.set_stride((2 * i + 1) * (2 * i + 1) / 2, odds.size(), 2 * i + 1,
+                        false);
+    odds.reset(0);
+    odds.for_each([&result](std::size_t i) { result.push_back(2 * i + 1); });
+    return result;
+  }
+
+  /**
+   * @brief Reset the odd multiples of the base primes in bits [first, last).
+   */
+  void sieve_segment(const std::vector<std::size_t> &base, std::size_t first,
+                     std::size_t last) {
+    for (std::size_t p : base) {
+      // bit i is a multiple of p when i = (p - 1) / 2 mod p, start at p * p
+      std::size_t start = p * p / 2;
+      if (start >= last)
+        break;
+      if (start < first)
+        start = first + ((p - 1) / 2 + p - first % p) % p;
+      odds_.set_stride(start, last, p, false);
+    }
+  }
+
+  std::size_t limit_;
+  /// Bit i is set when 2i + 1 is prime.
+  word_bitset odds_;
+};
+
+/**
+ * @brief Amount of primes up to n, see prime_sieve.
+ * @param threads Amount of threads, 0 uses the hardware concurrency.
+ */
+inline std::size_t prime_count(std::size_t n, std::size_t threads = 1) {
+  return prime_sieve(n, threads).count();
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef RESETTABLE_BITSET_H_
+#define RESETTABLE_BITSET_H_
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "word_bitset.hpp"
+
+/**
+ * @brief A bitset for sets that are filled sparsely and cleared often, such as
+ * the visited set of a search that runs thousands of times.
+ *
+ * Every word that gets a bit set is recorded once in a dirty list, so reset()
+ * clears only the recorded words and its cost follows the amount of words
+ * touched since the last reset instead of the capacity. A flag per word keeps
+ * the list free of duplicates, so it never grows past the amount of words.
+ */
+class resettable_bitset {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates an empty set.
+   * @param size Amount of bits.
+   */
+  explicit resettable_bitset(std::size_t size)
+      : size_(size), words_(bit_word::words_for(size), 0),
+        listed_(bit_word::words_for(words_.size()), 0) {
+    dirty_.reserve(words_.size());
+  }
+
+  /**
+   * @brief Return amount of bits
+   * @return Amount of bits
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Get the value of a bit.
+   */
+  bool test(std::size_t index) const {
+    return (words_[index / bit_word::bits] >> (index % bit_word::bits)) & 1;
+  }
+
+  /**
+   * @brief Set the value of a bit.
+   * @return Return object itself
+   */
+  resettable_bitset &set(std::size_t index, bool value = true) {
+    const std::size_t w = index / bit_word::bits;
+    const word_type mask = word_type(1) << (index % bit_word::bits);
+    if (value) {
+      touch(w);
+      words_[w] |= mask;
+    } else {
+      words_[w] &= ~mask;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Set a bit to false.
+   * @return Return object itself
+   */
+  resettable_bitset &reset(std::size_t index) { return set(index, false); }
+
+  /**
+   * @brief Set a bit and report its old value, the visit step of a search.
+   * @return True if the bit was already set.
+   */
+  bool test_and_set(std::size_t index) {
+    const std::size_t w = index / bit_word::bits;
+    const word_type mask = word_type(1) << (index % bit_word::bits);
+    if (words_[w] & mask)
+      return true;
+    touch(w);
+    words_[w] |= mask;
+    return false;
+  }
+
+  /**
+   * @brief Set every bit to false, clearing only the words touched since the
+   * last reset. Once most words are touched a straight fill is used.
+   * @return Return object itself
+   */
+  resettable_bitset &reset() {
+    if (dirty_.size() * 4 > words_.size()) {
+      std::fill(words_.begin(), words_.end(), 0);
+      std::fill(listed_.begin(), listed_.end(), 0);
+    } else {
+      for (std::size_t w : dirty_) {
+        words_[w] = 0;
+        listed_[w / bit_word::bits] = 0;
+      }
+    }
+    dirty_.clear();
+    return *this;
+  }
+
+  /**
+   * @brief Amount of words touched since the last reset.
+   */
+  std::size_t touched_words() const { return dirty_.size(); }
+
+  /**
+   * @brief Number of set bits, counted over the touched words only.
+   * @return Population count of the bitset
+   */
+  std::size_t count() const {
+    std::size_t total = 0;
+    for (std::size_t w : dirty_)
+      total += bit_word::popcount(words_[w]);
+    return total;
+  }
+
+  /**
+   * @brief Check if any bit is true.
+   * @return True if any bit is true, false otherwise.
+   */
+  bool any() const {
+    return std::any_of(dirty_.begin(), dirty_.end(),
+                       [this](std::size_t w) { return words_[w] != 0; });
+  }
+
+  /**
+   * @brief Check if none of the bits are true.
+   * @return True if none of the bits are true, false otherwise.
+   */
+  bool none() const { return !any(); }
+
+  /**
+   * @brief Call function with the index of every set bit, word by word in the
+   * order the words were first touched.
+   */
+  template <typename Function> void for_each(Function function) const {
+    for (std::size_t w : dirty_) {
+      word_type word = words_[w];
+      while (word) {
+        function(w * bit_word::bits + bit_word::count_trailing_zeros(word));
+        word &= word - 1;
+      }
+    }
+  }
+
+  /**
+   * @brief Copy into a word_bitset.
+   * @return New word_bitset with the same bits.
+   */
+  word_bitset to_word_bitset() const {
+    word_bitset result(size_);
+    for (std::size_t w : dirty_)
+      result.data()[w] = words_[w];
+    return result;
+  }
+
+private:
+  /**
+   * @brief Record word w in the dirty list unless it is already there.
+   */
+  void touch(std::size_t w) {
+    word_type &flags = listed_[w / bit_word::bits];
+    const word_type flag = word_type(1) << (w % bit_word::bits);
+    if (!(flags & flag)) {
+      flags |= flag;
+      dirty_.push_back(w);
+    }
+  }
+
+  std::size_t size_;
+  bit_word::word_vector words_;
+  /// Bit w is set when word w is in dirty_.
+  bit_word::word_vector listed_;
+  std::vector<std::size_t> dirty_;
+};
+
+#endif
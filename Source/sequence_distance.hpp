@@ -0,0 +1,140 @@
+#ifndef SEQUENCE_DISTANCE_H_
+#define SEQUENCE_DISTANCE_H_
+#include <cstddef>
+#include <string>
+
+#include "character_masks.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Bit-parallel edit distance and longest common subsequence against a
+ * fixed pattern.
+ *
+ * Both algorithms keep one column of the dynamic programming matrix as bit
+ * vectors of the pattern length and advance it by a text character with a
+ * constant amount of word operations per 64 pattern characters, so a pair
+ * costs O(text * pattern / 64).
+ *
+ * The pattern masks are built once and shared by every comparison, which
+ * makes comparing one record against many candidates cheap.
+ */
+class sequence_pattern {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that precomputes the character masks of a pattern.
+   * @param pattern Pattern, characters are bytes.
+   */
+  explicit sequence_pattern(const std::string &pattern) : masks_(pattern) {}
+
+  /**
+   * @brief Return length of the pattern
+   * @return Amount of characters
+   */
+  std::size_t size() const { return masks_.size(); }
+
+  /**
+   * @brief Levenshtein distance between the pattern and a text.
+   *
+   * Myers' algorithm with Hyyrö's block formulation: the vertical deltas of
+   * the column are kept as positive and negative bit vectors, and the
+   * horizontal delta leaving the top bit of a word enters the next word.
+   *
+   * @param text Text to compare.
+   * @return Smallest amount of insertions, deletions and substitutions.
+   */
+  std::size_t edit_distance(const std::string &text) const {
+    const std::size_t words = masks_.word_count();
+    if (words == 0)
+      return text.size();
+    const std::size_t last = words - 1;
+    const word_type top = word_type(1) << (bit_word::bits - 1);
+    bit_word::word_vector positive(words, ~word_type(0));
+    bit_word::word_vector negative(words, 0);
+    std::size_t score = size();
+    for (char c : text) {
+      const word_type *eq_words = masks_[c];
+      // the first row of the matrix grows by one per text character
+      int carry = 1;
+      for (std::size_t w = 0; w < words; ++w) {
+        const word_type pv = positive[w];
+        const word_type mv = negative[w];
+        word_type eq = eq_words[w];
+        const word_type xv = eq | mv;
+        eq |= static_cast<word_type>(carry < 0);
+        const word_type xh = (((eq & pv) + pv) ^ pv) | eq;
+        word_type ph = mv | ~(xh | pv);
+        word_type mh = pv & xh;
+        const word_type out = w == last ? masks_.last_bit() : top;
+        const int next = (ph & out) ? 1 : (mh & out) ? -1 : 0;
+        ph = (ph << 1) | static_cast<word_type>(carry > 0);
+        mh = (mh << 1) | static_cast<word_type>(carry < 0);
+        positive[w] = mh | ~(xv | ph);
+        negative[w] = ph & xv;
+        carry = next;
+      }
+      score += carry;
+    }
+    return score;
+  }
+
+  /**
+   * @brief Length of the longest common subsequence of the pattern and a text.
+   *
+   * Hyyrö's formulation of the Allison-Dix algorithm, V = (V + U) | (V - U)
+   * with U = V & mask[c], where the addition carries across words.
+   *
+   * @param text Text to compare.
+   * @return Amount of characters of the longest common subsequence.
+   */
+  std::size_t lcs_length(const std::string &text) const {
+    const std::size_t words = masks_.word_count();
+    if (words == 0)
+      return 0;
+    bit_word::word_vector v(words, ~word_type(0));
+    for (char c : text) {
+      const word_type *eq = masks_[c];
+      unsigned char carry = 0;
+      for (std::size_t w = 0; w < words; ++w) {
+        const word_type u = v[w] & eq[w];
+        // u is a subset of v so the subtraction never borrows
+        v[w] = bit_word::add_carry(v[w], u, carry) | (v[w] & ~u);
+      }
+    }
+    std::size_t zeros = 0;
+    for (std::size_t w = 0; w + 1 < words; ++w)
+      zeros += bit_word::popcount(~v[w]);
+    zeros += bit_word::popcount(~v[words - 1] & masks_.top_mask());
+    return zeros;
+  }
+
+private:
+  character_masks masks_;
+};
+
+/**
+ * @brief Levenshtein distance of two strings, see
+ * sequence_pattern::edit_distance.
+ *
+ * The longer string becomes the pattern so that short strings scan a short
+ * text.
+ *
+ * @return Smallest amount of insertions, deletions and substitutions.
+ */
+inline std::size_t edit_distance(const std::string &a, const std::string &b) {
+  return a.size() >= b.size() ? sequence_pattern(a).edit_distance(b)
+                              : sequence_pattern(b).edit_distance(a);
+}
+
+/**
+ * @brief Longest common subsequence length of two strings, see
+ * sequence_pattern::lcs_length.
+ * @return Amount of characters of the longest common subsequence.
+ */
+inline std::size_t lcs_length(const std::string &a, const std::string &b) {
+  return a.size() >= b.size() ? sequence_pattern(a).lcs_length(b)
+                              : sequence_pattern(b).lcs_length(a);
+}
+
+#endif
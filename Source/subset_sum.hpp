@@ -0,0 +1,67 @@
+#ifndef SUBSET_SUM_H_
+#define SUBSET_SUM_H_
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "word_bitset.hpp"
+
+/**
+ * @brief Every subset sum of weights up to capacity.
+ *
+ * Bitset dynamic programming: bit s is set when some subset of the weights
+ * sums to s, and every weight w applies reachable |= reachable << w with the
+ * fused word_bitset::or_shifted. A weight repeated c times is split into
+ * 1, 2, 4, ... copies (binary splitting), so it costs O(log c) passes
+ * instead of c.
+ *
+ * @param weights Item weights, weights above capacity are ignored.
+ * @param capacity Largest sum of interest.
+ * @return Bitset of capacity + 1 bits.
+ */
+inline word_bitset subset_sums(const std::vector<std::size_t> &weights,
+                               std::size_t capacity) {
+  std::map<std::size_t, std::size_t> multiplicity;
+  for (std::size_t weight : weights)
+    if (weight > 0 && weight <= capacity)
+      ++multiplicity[weight];
+  word_bitset reachable(capacity + 1);
+  reachable.set(0, true);
+  for (const auto &item : multiplicity) {
+    std::size_t left = item.second;
+    for (std::size_t copies = 1; left > 0; copies *= 2) {
+      const std::size_t take = copies < left ? copies : left;
+      if (item.first * take > capacity)
+        break;
+      reachable.or_shifted(reachable, item.first * take);
+      left -= take;
+    }
+  }
+  return reachable;
+}
+
+/**
+ * @brief Check if some subset of weights sums to exactly target.
+ * @return True if target is reachable.
+ */
+inline bool subset_sum(const std::vector<std::size_t> &weights,
+                       std::size_t target) {
+  return subset_sums(weights, target).test(target);
+}
+
+/**
+ * @brief Largest subset sum that does not exceed capacity, the 0/1 knapsack
+ * where the value of an item is its weight.
+ * @return Largest reachable sum, 0 when nothing fits.
+ */
+inline std::size_t max_subset_sum(const std::vector<std::size_t> &weights,
+                                  std::size_t capacity) {
+  const word_bitset reachable = subset_sums(weights, capacity);
+  for (std::size_t w = reachable.word_count(); w-- > 0;)
+    if (reachable.data()[w])
+      return w * bit_word::bits + bit_word::bits - 1 -
+             bit_word::count_leading_zeros(reachable.data()[w]);
+  return 0;
+}
+
+#endif
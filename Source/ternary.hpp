@@ -0,0 +1,164 @@
+#ifndef TERNARY_H_
+#define TERNARY_H_
+#include <algorithm>
+#include <cstddef>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Arbitrary three input boolean functions over words.
+ *
+ * A function is given by its truth table Table, an 8 bit immediate where bit
+ * ((a << 2) | (b << 1) | c) is the result for inputs a, b and c. This is the
+ * encoding of the AVX-512 vpternlogq instruction.
+ */
+namespace ternary_logic {
+/**
+ * @brief Any two input function of b and c given by a 4 bit truth table.
+ */
+template <unsigned Table>
+inline bit_word::word_type binary(bit_word::word_type b,
+                                  bit_word::word_type c) {
+  switch (Table & 0xF) {
+  case 0x0:
+    return 0;
+  case 0x1:
+    return ~(b | c);
+  case 0x2:
+    return ~b & c;
+  case 0x3:
+    return ~b;
+  case 0x4:
+    return b & ~c;
+  case 0x5:
+    return ~c;
+  case 0x6:
+    return b ^ c;
+  case 0x7:
+    return ~(b & c);
+  case 0x8:
+    return b & c;
+  case 0x9:
+    return ~(b ^ c);
+  case 0xA:
+    return c;
+  case 0xB:
+    return ~b | c;
+  case 0xC:
+    return b;
+  case 0xD:
+    return b | ~c;
+  case 0xE:
+    return b | c;
+  default:
+    return ~bit_word::word_type(0);
+  }
+}
+
+/**
+ * @brief Evaluate a truth table on three words.
+ *
+ * Shannon expansion on a: when both halves of the table are equal a is
+ * ignored, when they are complements the result is a ^ half, otherwise the
+ * halves are blended with f0 ^ (a & (f0 ^ f1)).
+ */
+template <unsigned Table>
+inline bit_word::word_type word(bit_word::word_type a, bit_word::word_type b,
+                                bit_word::word_type c) {
+  const unsigned low = Table & 0xF;
+  const unsigned high = (Table >> 4) & 0xF;
+  const bit_word::word_type f0 = binary<Table & 0xF>(b, c);
+  if (low == high)
+    return f0;
+  if ((low ^ high) == 0xF)
+    return a ^ f0;
+  const bit_word::word_type f1 = binary<(Table >> 4) & 0xF>(b, c);
+  return f0 ^ (a & (f0 ^ f1));
+}
+
+/**
+ * @brief Evaluate a truth table over count words.
+ */
+template <unsigned Table>
+inline void words(bit_word::word_type *out, const bit_word::word_type *a,
+                  const bit_word::word_type *b, const bit_word::word_type *c,
+                  std::size_t count) {
+  std::size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 8 <= count; i += 8)
+    _mm512_storeu_si512(out + i,
+                        _mm512_ternarylogic_epi64(_mm512_loadu_si512(a + i),
+                                                  _mm512_loadu_si512(b + i),
+                                                  _mm512_loadu_si512(c + i),
+                                                  Table & 0xFF));
+#endif
+  for (; i < count; ++i)
+    out[i] = word<Table>(a[i], b[i], c[i]);
+}
+} // namespace ternary_logic
+
+/**
+ * @brief Apply a three input boolean function to every bit position.
+ *
+ * Computes the result in a single pass without temporaries, using
+ * vpternlogq when compiled for AVX-512.
+ *
+ * @tparam Table Truth table, bit ((a << 2) | (b << 1) | c) is the result.
+ * @return New word_bitset of the size of a.
+ */
+template <unsigned Table>
+word_bitset ternary(const word_bitset &a, const word_bitset &b,
+                    const word_bitset &c) {
+  word_bitset result(a.size());
+  ternary_logic::words<Table>(
+      result.data(), a.data(), b.data(), c.data(),
+      std::min({a.word_count(), b.word_count(), c.word_count()}));
+  result.trim();
+  return result;
+}
+
+/**
+ * @brief Apply a three input boolean function to every bit position.
+ * @tparam Table Truth table, bit ((a << 2) | (b << 1) | c) is the result.
+ * @return New dynamic_bitset of the size of a.
+ */
+template <unsigned Table, std::size_t N>
+dynamic_bitset<> ternary(const dynamic_bitset<N> &a, const dynamic_bitset<N> &b,
+                         const dynamic_bitset<N> &c) {
+  return ternary<Table>(word_bitset(a), word_bitset(b), word_bitset(c))
+      .to_dynamic_bitset();
+}
+
+/**
+ * @brief a & ~b
+ * @return New word_bitset
+ */
+inline word_bitset and_not(const word_bitset &a, const word_bitset &b) {
+  return ternary<0x30>(a, b, b);
+}
+
+/**
+ * @brief Bits of b where mask is set and bits of a elsewhere,
+ * (a & ~mask) | (b & mask).
+ * @return New word_bitset
+ */
+inline word_bitset blend(const word_bitset &mask, const word_bitset &a,
+                         const word_bitset &b) {
+  return ternary<0xAC>(mask, a, b);
+}
+
+/**
+ * @brief Bits set in at least two of a, b and c.
+ * @return New word_bitset
+ */
+inline word_bitset majority(const word_bitset &a, const word_bitset &b,
+                            const word_bitset &c) {
+  return ternary<0xE8>(a, b, c);
+}
+
+#endif
@@ -0,0 +1,316 @@
+#ifndef TRACKED_BITSET_H_
+#define TRACKED_BITSET_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Changed words of a bitset, as runs of consecutive words.
+ *
+ * Applying a delta overwrites the words of every run, so a replica that held
+ * the state of the last checkpoint receives the current state. The binary
+ * form written by write() is little endian 64 bit integers: the size in bits,
+ * the amount of runs, a (first word, word count) pair per run and then the
+ * words of all runs back to back.
+ */
+struct bitset_delta {
+  using word_type = bit_word::word_type;
+
+  /// Words [first, first + count) of the bitset.
+  struct run {
+    std::size_t first;
+    std::size_t count;
+  };
+
+  /// Amount of bits of the tracked bitset.
+  std::size_t size = 0;
+  std::vector<run> runs;
+  /// Contents of the runs back to back.
+  std::vector<word_type> words;
+
+  /**
+   * @brief Check if the delta changes nothing.
+   */
+  bool empty() const { return runs.empty(); }
+
+  /**
+   * @brief Amount of bytes of the binary form.
+   */
+  std::size_t bytes() const {
+    return 8 * (2 + 2 * runs.size() + words.size());
+  }
+
+  /**
+   * @brief Write the binary form.
+   */
+  void write(std::ostream &out) const {
+    put(out, size);
+    put(out, runs.size());
+    for (const run &r : runs) {
+      put(out, r.first);
+      put(out, r.count);
+    }
+    for (word_type word : words)
+      put(out, word);
+  }
+
+  /**
+   * @brief Read the binary form written by write().
+   * @return New bitset_delta
+   */
+  static bitset_delta read(std::istream &in) {
+    bitset_delta delta;
+    delta.size = get(in);
+    const std::size_t runs = get(in);
+    const std::size_t limit = bit_word::words_for(delta.size);
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < runs; ++i) {
+      const std::size_t first = get(in);
+      const std::size_t count = get(in);
+      if (first > limit || count > limit - first || count > limit - total)
+        throw std::runtime_error("bitset_delta run out of range");
+      delta.runs.push_back({first, count});
+      total += count;
+    }
+    // no reserve, the counts are not trusted before the words arrive
+    for (std::size_t i = 0; i < total; ++i)
+      delta.words.push_back(get(in));
+    return delta;
+  }
+
+  /**
+   * @brief Overwrite the changed words of a word_bitset of the same size.
+   * The runs are checked before any word is written, so a bad delta leaves
+   * target unchanged.
+   */
+  void apply(word_bitset &target) const {
+    if (target.size() != size)
+      throw std::invalid_argument("bitset_delta size does not match");
+    const std::size_t limit = target.word_count();
+    std::size_t total = 0;
+    for (const run &r : runs) {
+      if (r.first > limit || r.count > limit - r.first)
+        throw std::invalid_argument("bitset_delta run out of range");
+      if (r.count > words.size() - total)
+        throw std::invalid_argument("bitset_delta words do not match its runs");
+      total += r.count;
+    }
+    if (total != words.size())
+      throw std::invalid_argument("bitset_delta words do not match its runs");
+    const word_type *source = words.data();
+    for (const run &r : runs) {
+      std::copy(source, source + r.count, target.data() + r.first);
+      source += r.count;
+    }
+    target.trim();
+  }
+
+private:
+  static void put(std::ostream &out, std::uint64_t value) {
+    unsigned char bytes[8];
+    for (unsigned i = 0; i < 8; ++i)
+      bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    out.write(reinterpret_cast<const char *>(bytes), 8);
+  }
+
+  static std::uint64_t get(std::istream &in) {
+    unsigned char bytes[8];
+    if (!in.read(reinterpret_cast<char *>(bytes), 8))
+      throw std::runtime_error("bitset_delta is truncated");
+    std::uint64_t value = 0;
+    for (unsigned i = 8; i-- > 0;)
+      value = (value << 8) | bytes[i];
+    return value;
+  }
+};
+
+/**
+ * @brief A word_bitset that records which words changed since the last
+ * checkpoint, for shipping incremental deltas to replicas.
+ *
+ * A second level bitset holds one bit per word. Every write sets the bit of
+ * its word, and checkpoint() turns the marked words into runs of a
+ * bitset_delta, so the cost of a delta follows the changed words and a scan
+ * of one bit per word instead of the whole set.
+ */
+class tracked_bitset {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that creates a clean set of zeros.
+   * @param size Amount of bits.
+   */
+  explicit tracked_bitset(std::size_t size)
+      : bits_(size), dirty_(bits_.word_count()) {}
+
+  /**
+   * @brief Constructor that starts tracking a copy of bits, nothing is dirty.
+   */
+  explicit tracked_bitset(const word_bitset &bits)
+      : bits_(bits), dirty_(bits_.word_count()) {}
+
+  /**
+   * @brief Constructor that starts tracking a copy of a dynamic_bitset.
+   */
+  template <std::size_t N>
+  explicit tracked_bitset(const dynamic_bitset<N> &bits)
+      : tracked_bitset(word_bitset(bits)) {}
+
+  /**
+   * @brief Return amount of bits
+   * @return Amount of bits
+   */
+  std::size_t size() const { return bits_.size(); }
+
+  /**
+   * @brief Access the current bits.
+   */
+  const word_bitset &bits() const { return bits_; }
+
+  /**
+   * @brief Get the value of a bit.
+   */
+  bool test(std::size_t index) const { return bits_.test(index); }
+
+  /**
+   * @brief Set the value of a bit.
+   * @return Return object itself
+   */
+  tracked_bitset &set(std::size_t index, bool value = true) {
+    bits_.set(index, value);
+    dirty_.set(index / bit_word::bits, true);
+    return *this;
+  }
+
+  /**
+   * @brief Set a bit to false.
+   * @return Return object itself
+   */
+  tracked_bitset &reset(std::size_t index) { return set(index, false); }
+
+  /**
+   * @brief Set the bits in [first, last) to the given value.
+   * @return Return object itself
+   */
+  tracked_bitset &set_range(std::size_t first, std::size_t last, bool value) {
+    if (first >= last)
+      return *this;
+    bits_.set_range(first, last, value);
+    dirty_.set_range(first / bit_word::bits,
+                     (last - 1) / bit_word::bits + 1, true);
+    return *this;
+  }
+
+  /**
+   * @brief Number of set bits
+   * @return Population count of the bitset
+   */
+  std::size_t count() const { return bits_.count(); }
+
+  /**
+   * @brief Amount of words changed since the last checkpoint.
+   */
+  std::size_t dirty_words() const { return dirty_.count(); }
+
+  /**
+   * @brief Changes since the last checkpoint, without starting a new one.
+   * @return New bitset_delta with the runs of changed words.
+   */
+  bitset_delta delta() const {
+    bitset_delta result;
+    result.size = bits_.size();
+    for_each_dirty_run([&](std::size_t first, std::size_t count) {
+      result.runs.push_back({first, count});
+      result.words.insert(result.words.end(), bits_.data() + first,
+                          bits_.data() + first + count);
+    });
+    return result;
+  }
+
+  /**
+   * @brief Call function with the first word and the word count of every run
+   * of words changed since the last checkpoint, in ascending order, without
+   * copying the words.
+   */
+  template <typename Function>
+  void for_each_dirty_run(Function function) const {
+    std::size_t first = 0, count = 0;
+    dirty_.for_each([&](std::size_t w) {
+      if (count && first + count == w) {
+        ++count;
+        return;
+      }
+      if (count)
+        function(first, count);
+      first = w;
+      count = 1;
+    });
+    if (count)
+      function(first, count);
+  }
+
+  /**
+   * @brief Changes since the last checkpoint, then start a new checkpoint.
+   * @return New bitset_delta with the runs of changed words.
+   */
+  bitset_delta checkpoint() {
+    bitset_delta result = delta();
+    mark_clean();
+    return result;
+  }
+
+  /**
+   * @brief Start a new checkpoint without building a delta, for callers that
+   * stored the result of delta() themselves.
+   */
+  void mark_clean() { dirty_.reset(); }
+
+  /**
+   * @brief The whole set as a single run, to seed a replica.
+   * @return New bitset_delta
+   */
+  bitset_delta snapshot() const {
+    bitset_delta result;
+    result.size = bits_.size();
+    if (bits_.word_count())
+      result.runs.push_back({0, bits_.word_count()});
+    result.words.assign(bits_.data(), bits_.data() + bits_.word_count());
+    return result;
+  }
+
+  /**
+   * @brief Apply a delta of another tracked_bitset. The overwritten words are
+   * marked dirty, so a replica can pass the changes on.
+   * @return Return object itself
+   */
+  tracked_bitset &apply(const bitset_delta &delta) {
+    delta.apply(bits_);
+    for (const bitset_delta::run &r : delta.runs)
+      if (r.count)
+        dirty_.set_range(r.first, r.first + r.count, true);
+    return *this;
+  }
+
+  /**
+   * @brief Unpack into a dynamic_bitset.
+   * @return New dynamic_bitset with the same bits.
+   */
+  dynamic_bitset<> to_dynamic_bitset() const {
+    return bits_.to_dynamic_bitset();
+  }
+
+private:
+  word_bitset bits_;
+  /// Bit w is set when word w changed since the last checkpoint.
+  word_bitset dirty_;
+};
+
+#endif
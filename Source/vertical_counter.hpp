@@ -0,0 +1,211 @@
+#ifndef VERTICAL_COUNTER_H_
+#define VERTICAL_COUNTER_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bit_sliced_index.hpp"
+#include "bitset_array.hpp"
+#include "dynamic_bitset.hpp"
+#include "word_bitset.hpp"
+
+/**
+ * @brief Per position population counts across many bitsets.
+ *
+ * For every bit position the amount of input bitsets that have it set is
+ * kept as a vertical (bit sliced) counter: slice j holds bit j of every
+ * count. The counts are accumulated a word column at a time with a carry
+ * save adder tree that folds eight inputs into the ones, twos and fours
+ * slices and ripples the eights carry upwards, so no per bit loop is needed.
+ *
+ * Threshold masks such as at_least(k) are O'Neil comparisons over the
+ * slices, see bit_sliced_index::compare.
+ */
+class vertical_counter {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Constructor that counts a vector of bitsets of equal size.
+   * @param sets The input bitsets.
+   */
+  explicit vertical_counter(const std::vector<word_bitset> &sets)
+      : inputs_(sets.size()) {
+    const std::size_t size = sets.empty() ? 0 : sets.front().size();
+    for (const auto &set : sets)
+      if (set.size() != size)
+        throw std::invalid_argument("vertical_counter sizes do not match");
+    accumulate(size, [&sets](std::size_t i, std::size_t w) {
+      return sets[i].data()[w];
+    });
+  }
+
+  /**
+   * @brief Constructor that counts a vector of dynamic_bitset of equal size.
+   * @param sets The input bitsets.
+   */
+  template <std::size_t N>
+  explicit vertical_counter(const std::vector<dynamic_bitset<N>> &sets)
+      : vertical_counter(pack(sets)) {}
+
+  /**
+   * @brief Constructor that counts the rows of a bitset_array.
+   * @param rows The input bitsets.
+   */
+  explicit vertical_counter(const bitset_array &rows) : inputs_(rows.rows()) {
+    accumulate(rows.bits(), [&rows](std::size_t i, std::size_t w) {
+      return rows.word(i, w);
+    });
+  }
+
+  /**
+   * @brief Return amount of bit positions
+   * @return Size of the input bitsets
+   */
+  std::size_t size() const { return counts_.size(); }
+
+  /**
+   * @brief Return amount of input bitsets
+   * @return Amount of inputs
+   */
+  std::size_t inputs() const { return inputs_; }
+
+  /**
+   * @brief Access the counter slices.
+   * @return Counts as a bit sliced column.
+   */
+  const bit_sliced_index<std::uint32_t> &slices() const { return counts_; }
+
+  /**
+   * @brief Amount of inputs that have a bit set.
+   * @param position Bit position.
+   * @return Count of the position.
+   */
+  std::uint32_t count(std::size_t position) const {
+    return counts_.value(position);
+  }
+
+  /**
+   * @brief Count of every position.
+   * @return Count of position i at index i.
+   */
+  std::vector<std::uint32_t> counts() const {
+    std::vector<std::uint32_t> result(size(), 0);
+    for (std::size_t j = 0; j < counts_.slice_count(); ++j)
+      counts_.slice(j).for_each([&result, j](std::size_t i) {
+        result[i] |= std::uint32_t(1) << j;
+      });
+    return result;
+  }
+
+  /**
+   * @brief Positions set in at least k inputs.
+   * @return Packed bits of the positions.
+   */
+  word_bitset at_least(std::size_t k) const {
+    return compare(compare_op::greater_equal, k);
+  }
+
+  /**
+   * @brief Positions set in at most k inputs.
+   * @return Packed bits of the positions.
+   */
+  word_bitset at_most(std::size_t k) const {
+    return compare(compare_op::less_equal, k);
+  }
+
+  /**
+   * @brief Positions set in exactly k inputs.
+   * @return Packed bits of the positions.
+   */
+  word_bitset exactly(std::size_t k) const {
+    return compare(compare_op::equal, k);
+  }
+
+  /**
+   * @brief Positions set in more than half of the inputs.
+   * @return Packed bits of the positions.
+   */
+  word_bitset majority() const { return at_least(inputs_ / 2 + 1); }
+
+private:
+  template <std::size_t N>
+  static std::vector<word_bitset>
+  pack(const std::vector<dynamic_bitset<N>> &sets) {
+    std::vector<word_bitset> packed;
+    packed.reserve(sets.size());
+    for (const auto &set : sets)
+      packed.emplace_back(set);
+    return packed;
+  }
+
+  word_bitset compare(compare_op op, std::size_t k) const {
+    if (k > 0xFFFFFFFFULL)
+      return word_bitset(size(), op == compare_op::less_equal);
+    return counts_.compare(op, static_cast<std::uint32_t>(k));
+  }
+
+  /**
+   * @brief Carry save adder, (high, low) = a + b + c.
+   */
+  static void csa(word_type &high, word_type &low, word_type a, word_type b,
+                  word_type c) {
+    const word_type u = a ^ b;
+    high = (a & b) | (u & c);
+    low = u ^ c;
+  }
+
+  /**
+   * @brief Add a word of weight 2^level to the column counters.
+   */
+  static void ripple(word_type *counter, std::size_t slices, std::size_t level,
+                     word_type carry) {
+    for (std::size_t j = level; carry && j < slices; ++j) {
+      const word_type next = counter[j] & carry;
+      counter[j] ^= carry;
+      carry = next;
+    }
+  }
+
+  /**
+   * @brief Build the counter slices, word(i, w) is word w of input i.
+   */
+  template <typename Word> void accumulate(std::size_t size, Word word) {
+    std::size_t slices = 0;
+    while (slices < 32 && (inputs_ >> slices) != 0)
+      ++slices;
+    std::vector<word_bitset> result(slices, word_bitset(size));
+
+    word_type counter[32];
+    const std::size_t words = bit_word::words_for(size);
+    for (std::size_t w = 0; w < words; ++w) {
+      std::fill(counter, counter + 32, 0);
+      std::size_t i = 0;
+      // 8 inputs at a time: ones, twos and fours stay in counter[0..2]
+      for (; i + 8 <= inputs_; i += 8) {
+        word_type twos_a, twos_b, fours_a, fours_b, eights;
+        csa(twos_a, counter[0], counter[0], word(i, w), word(i + 1, w));
+        csa(twos_b, counter[0], counter[0], word(i + 2, w), word(i + 3, w));
+        csa(fours_a, counter[1], counter[1], twos_a, twos_b);
+        csa(twos_a, counter[0], counter[0], word(i + 4, w), word(i + 5, w));
+        csa(twos_b, counter[0], counter[0], word(i + 6, w), word(i + 7, w));
+        csa(fours_b, counter[1], counter[1], twos_a, twos_b);
+        csa(eights, counter[2], counter[2], fours_a, fours_b);
+        ripple(counter, slices, 3, eights);
+      }
+      for (; i < inputs_; ++i)
+        ripple(counter, slices, 0, word(i, w));
+      for (std::size_t j = 0; j < slices; ++j)
+        result[j].data()[w] = counter[j];
+    }
+    counts_ = bit_sliced_index<std::uint32_t>(size, std::move(result));
+  }
+
+  std::size_t inputs_;
+  bit_sliced_index<std::uint32_t> counts_;
+};
+
+#endif
@@ -0,0 +1,786 @@
+#ifndef WORD_BITSET_H_
+#define WORD_BITSET_H_
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "dynamic_bitset.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Word level helpers shared by the packed bitset kernels.
+ */
+namespace bit_word {
+using word_type = std::uint64_t;
+
+/**
+ * @brief Number of bits stored in a single word.
+ */
+constexpr std::size_t bits = 64;
+
+/**
+ * @brief Marker returned by searches that did not find a set bit.
+ */
+constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+/**
+ * @brief Number of words needed to store the given amount of bits.
+ * @param bit_count Amount of bits.
+ * @return Amount of words.
+ */
+inline std::size_t words_for(std::size_t bit_count) {
+  return (bit_count + bits - 1) / bits;
+}
+
+/**
+ * @brief Mask with the lowest count bits set.
+ * @param count Amount of low bits, in range [0, 64].
+ * @return Mask word.
+ */
+inline word_type low_mask(std::size_t count) {
+  return count >= bits ? ~word_type(0) : (word_type(1) << count) - 1;
+}
+
+/**
+ * @brief Number of set bits in a word.
+ * @param word Word to count.
+ * @return Population count of word.
+ */
+inline int popcount(word_type word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<int>(__popcnt64(word));
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief Index of the lowest set bit of a word.
+ * @param word Word to search, must not be zero.
+ * @return Index of the lowest set bit.
+ */
+inline int count_trailing_zeros(word_type word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return static_cast<int>(index);
+#else
+  int index = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+/**
+ * @brief Number of zero bits above the highest set bit of a word.
+ * @param word Word to search, must not be zero.
+ * @return Amount of leading zero bits.
+ */
+inline int count_leading_zeros(word_type word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanReverse64(&index, word);
+  return 63 - static_cast<int>(index);
+#else
+  int count = 0;
+  while (!(word & (word_type(1) << 63))) {
+    word <<= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+/**
+ * @brief Add two words and an incoming carry, adc on x86-64.
+ * @param a First word.
+ * @param b Second word.
+ * @param carry Carry in, 0 or 1, replaced with the carry out.
+ * @return Low 64 bits of the sum.
+ */
+inline word_type add_carry(word_type a, word_type b, unsigned char &carry) {
+#if defined(__x86_64__) || defined(_M_X64)
+  unsigned long long sum;
+  carry = _addcarry_u64(carry, a, b, &sum);
+  return sum;
+#else
+  const word_type partial = a + b;
+  const word_type sum = partial + carry;
+  carry = static_cast<unsigned char>((partial < a) | (sum < partial));
+  return sum;
+#endif
+}
+
+/**
+ * @brief Subtract a word and an incoming borrow from a word, sbb on x86-64.
+ * @param a Minuend.
+ * @param b Subtrahend.
+ * @param borrow Borrow in, 0 or 1, replaced with the borrow out.
+ * @return Low 64 bits of the difference.
+ */
+inline word_type sub_borrow(word_type a, word_type b, unsigned char &borrow) {
+#if defined(__x86_64__) || defined(_M_X64)
+  unsigned long long difference;
+  borrow = _subborrow_u64(borrow, a, b, &difference);
+  return difference;
+#else
+  const word_type partial = a - b;
+  const word_type difference = partial - borrow;
+  borrow = static_cast<unsigned char>((a < b) | (partial < borrow));
+  return difference;
+#endif
+}
+
+/**
+ * @brief Scramble a word (splitmix64 finalizer).
+ * @param word Word to scramble.
+ * @return Well mixed word.
+ */
+inline word_type mix(word_type word) {
+  word += 0x9E3779B97F4A7C15ULL;
+  word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  word = (word ^ (word >> 27)) * 0x94D049BB133111EBULL;
+  return word ^ (word >> 31);
+}
+
+/**
+ * @brief Amount of sampled words for a popcount estimate whose error is below
+ * error * bits with about 95% confidence (Hoeffding bound).
+ * @param error Allowed error as a fraction of the amount of bits.
+ * @return Amount of words to sample.
+ */
+inline std::size_t sample_size(double error) {
+  if (!(error > 0))
+    return npos;
+  return static_cast<std::size_t>(
+      std::ceil(std::log(2 / 0.05) / (2 * error * error)));
+}
+
+/**
+ * @brief Estimate the popcount of a sequence of words from a given amount of
+ * samples.
+ *
+ * The words are split into samples strata and one pseudo randomly placed word
+ * of every stratum is counted and weighted by the stratum length. When the
+ * sample would cover every word the exact popcount is returned.
+ *
+ * @param words Amount of words.
+ * @param samples Amount of words to count.
+ * @param word Callable returning the word at a given index.
+ * @return Estimated popcount.
+ */
+template <typename Word>
+std::size_t sampled_popcount(std::size_t words, std::size_t samples,
+                             Word word) {
+  std::size_t total = 0;
+  if (samples >= words) {
+    for (std::size_t i = 0; i < words; ++i)
+      total += popcount(word(i));
+    return total;
+  }
+  double weighted = 0;
+  for (std::size_t i = 0; i < samples; ++i) {
+    const std::size_t first = i * words / samples;
+    const std::size_t length = (i + 1) * words / samples - first;
+    weighted += static_cast<double>(popcount(word(first + mix(i) % length))) *
+                static_cast<double>(length);
+  }
+  return static_cast<std::size_t>(weighted + 0.5);
+}
+
+/**
+ * @brief Estimate the popcount of a sequence of words by stratified sampling
+ * of sample_size(error) words, see sampled_popcount.
+ *
+ * @param words Amount of words.
+ * @param error Allowed error as a fraction of words * 64.
+ * @param word Callable returning the word at a given index.
+ * @return Estimated popcount.
+ */
+template <typename Word>
+std::size_t estimate_popcount(std::size_t words, double error, Word word) {
+  return sampled_popcount(words, sample_size(error), word);
+}
+
+/**
+ * @brief Allocator returning storage aligned to Alignment bytes.
+ *
+ * Used so that word storage starts on a cache line, which keeps blocked
+ * layouts inside a single line and allows aligned SIMD loads.
+ */
+template <typename T, std::size_t Alignment = 64> class aligned_allocator {
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+  aligned_allocator() = default;
+
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, Alignment> &) {}
+
+  /**
+   * @brief Allocate count objects, the original pointer is kept in front of
+   * the aligned block.
+   */
+  T *allocate(std::size_t count) {
+    const std::size_t bytes = count * sizeof(T) + Alignment + sizeof(void *);
+    void *raw = std::malloc(bytes);
+    if (!raw)
+      throw std::bad_alloc();
+    const std::uintptr_t start =
+        reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+    const std::uintptr_t aligned =
+        (start + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+    reinterpret_cast<void **>(aligned)[-1] = raw;
+    return reinterpret_cast<T *>(aligned);
+  }
+
+  /**
+   * @brief Release storage returned by allocate.
+   */
+  void deallocate(T *pointer, std::size_t) {
+    if (pointer)
+      std::free(reinterpret_cast<void **>(pointer)[-1]);
+  }
+
+  template <typename U>
+  bool operator==(const aligned_allocator<U, Alignment> &) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const aligned_allocator<U, Alignment> &) const {
+    return false;
+  }
+};
+
+/**
+ * @brief Cache line aligned word storage.
+ */
+using word_vector = std::vector<word_type, aligned_allocator<word_type>>;
+} // namespace bit_word
+
+/**
+ * @brief A fixed size bitset packed into 64 bit words.
+ *
+ * word_bitset is the storage used by the word level kernels built on top of
+ * dynamic_bitset. Bit i of the set lives in bit (i % 64) of word (i / 64), so
+ * index i refers to the same position as operator[](i) of dynamic_bitset.
+ * Unused bits of the last word are always kept zero and the words start on a
+ * cache line.
+ */
+class word_bitset {
+public:
+  using word_type = bit_word::word_type;
+
+  /**
+   * @brief Default constructor that creates an empty bitset.
+   */
+  word_bitset() : size_(0) {}
+
+  /**
+   * @brief Constructor that creates a bitset with the given size.
+   *
+   * @param size Amount of bits.
+   * @param value Initial value of every bit.
+   */
+  explicit word_bitset(std::size_t size, bool value = false)
+      : words_(bit_word::words_for(size), value ? ~word_type(0) : 0),
+        size_(size) {
+    trim();
+  }
+
+  /**
+   * @brief Constructor that packs the bits of a dynamic_bitset.
+   *
+   * @param set The dynamic_bitset to pack.
+   */
+  template <std::size_t N>
+  explicit word_bitset(const dynamic_bitset<N> &set) : word_bitset(set.size()) {
+    const auto &bits = set.get();
+    for (std::size_t i = 0; i < size_; ++i)
+      if (bits[i])
+        words_[i / bit_word::bits] |= word_type(1) << (i % bit_word::bits);
+  }
+
+  /**
+   * @brief Return size of the bitset
+   * @return Amount of bits
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Return amount of storage words
+   * @return Amount of words
+   */
+  std::size_t word_count() const { return words_.size(); }
+
+  /**
+   * @brief Access the underlying words.
+   * @return Pointer to the first word.
+   */
+  word_type *data() { return words_.data(); }
+
+  /**
+   * @brief Access the underlying words.
+   * @return Pointer to the first word.
+   */
+  const word_type *data() const { return words_.data(); }
+
+  /**
+   * @brief Get the value of a bit at a given index.
+   * @param index The index of the bit.
+   * @return The value of the bit at the given index.
+   */
+  bool operator[](std::size_t index) const { return test(index); }
+
+  /**
+   * @brief Get the value of a bit at a given index.
+   * @param index The index of the bit.
+   * @return The value of the bit at the given index.
+   */
+  bool test(std::size_t index) const {
+    return (words_[index / bit_word::bits] >> (index % bit_word::bits)) & 1;
+  }
+
+  /**
+   * @brief Set the value of a single bit.
+   * @param index The index of the bit.
+   * @param value The new value.
+   * @return Return object itself
+   */
+  word_bitset &set(std::size_t index, bool value) {
+    const word_type mask = word_type(1) << (index % bit_word::bits);
+    if (value)
+      words_[index / bit_word::bits] |= mask;
+    else
+      words_[index / bit_word::bits] &= ~mask;
+    return *this;
+  }
+
+  /**
+   * @brief Set all value of the bitset
+   * @return Return object itself
+   */
+  word_bitset &set(bool value) {
+    std::fill(words_.begin(), words_.end(), value ? ~word_type(0) : 0);
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief Set a single bit to 0
+   * @return Return object itself
+   */
+  word_bitset &reset(std::size_t index) { return set(index, false); }
+
+  /**
+   * @brief Set all value to 0
+   * @return Return object itself
+   */
+  word_bitset &reset() { return set(false); }
+
+  /**
+   * @brief Set the bits in [first, last) to the given value.
+   * @return Return object itself
+   */
+  word_bitset &set_range(std::size_t first, std::size_t last, bool value) {
+    check_range(last);
+    if (first >= last)
+      return *this;
+    const std::size_t first_word = first / bit_word::bits;
+    const std::size_t last_word = (last - 1) / bit_word::bits;
+    for (std::size_t w = first_word; w <= last_word; ++w) {
+      word_type mask = ~word_type(0);
+      if (w == first_word)
+        mask &= ~bit_word::low_mask(first % bit_word::bits);
+      if (w == last_word)
+        mask &= bit_word::low_mask(last - w * bit_word::bits);
+      if (value)
+        words_[w] |= mask;
+      else
+        words_[w] &= ~mask;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Set the bits first, first + step, ... below last to the given
+   * value.
+   * @return Return object itself
+   */
+  word_bitset &set_stride(std::size_t first, std::size_t last, std::size_t step,
+                          bool value) {
+    if (step == 0)
+      throw std::invalid_argument("word_bitset stride must be positive");
+    check_range(last);
+    word_type *words = words_.data();
+    if (value)
+      for (std::size_t i = first; i < last; i += step)
+        words[i / bit_word::bits] |= word_type(1) << (i % bit_word::bits);
+    else
+      for (std::size_t i = first; i < last; i += step)
+        words[i / bit_word::bits] &= ~(word_type(1) << (i % bit_word::bits));
+    return *this;
+  }
+
+  /**
+   * @brief Change the size of the bitset, new bits are 0.
+   * @param size The new amount of bits.
+   */
+  void resize(std::size_t size) {
+    size_ = std::min(size_, size);
+    trim();
+    words_.resize(bit_word::words_for(size), 0);
+    size_ = size;
+  }
+
+  /**
+   * @brief Number of set bits
+   * @return Population count of the bitset
+   */
+  std::size_t count() const {
+    std::size_t total = 0;
+    for (const auto word : words_)
+      total += bit_word::popcount(word);
+    return total;
+  }
+
+  /**
+   * @brief Number of set bits in [first, last).
+   * @return Population count of the range
+   */
+  std::size_t count_range(std::size_t first, std::size_t last) const {
+    check_range(last);
+    if (first >= last)
+      return 0;
+    const std::size_t first_word = first / bit_word::bits;
+    const std::size_t last_word = (last - 1) / bit_word::bits;
+    std::size_t total = 0;
+    for (std::size_t w = first_word; w <= last_word; ++w) {
+      word_type word = words_[w];
+      if (w == first_word)
+        word &= ~bit_word::low_mask(first % bit_word::bits);
+      if (w == last_word)
+        word &= bit_word::low_mask(last - w * bit_word::bits);
+      total += bit_word::popcount(word);
+    }
+    return total;
+  }
+
+  /**
+   * @brief Check if any bit is true.
+   * @return True if any bit is true, false otherwise.
+   */
+  bool any() const {
+    return std::any_of(words_.begin(), words_.end(),
+                       [](word_type w) { return w != 0; });
+  }
+
+  /**
+   * @brief Check if none of the bits are true.
+   * @return True if none of the bits are true, false otherwise.
+   */
+  bool none() const { return !any(); }
+
+  /**
+   * @brief Check if all bits are true.
+   * @return True if all bits are true, false otherwise.
+   */
+  bool all() const { return count() == size_; }
+
+  /**
+   * @brief Estimate the number of set bits from a sample of the words.
+   * @param error Allowed error as a fraction of size(), about 95% confidence.
+   * @return Estimated population count, exact for small bitsets.
+   */
+  std::size_t estimate_count(double error = 0.01) const {
+    const word_type *words = words_.data();
+    return std::min(size_, bit_word::estimate_popcount(
+                               words_.size(), error,
+                               [words](std::size_t i) { return words[i]; }));
+  }
+
+  /**
+   * @brief Index of the first set bit.
+   * @return Index of the bit, bit_word::npos if there is none.
+   */
+  std::size_t find_first() const { return find_from(0); }
+
+  /**
+   * @brief Index of the first set bit after position.
+   * @param position Bit index to search after.
+   * @return Index of the bit, bit_word::npos if there is none.
+   */
+  std::size_t find_next(std::size_t position) const {
+    if (size_ == 0 || position >= size_ - 1)
+      return bit_word::npos;
+    return find_from(position + 1);
+  }
+
+  /**
+   * @brief Call function with the index of every set bit in ascending order.
+   * @param function Callable taking a std::size_t.
+   */
+  template <typename Function> void for_each(Function function) const {
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+      word_type word = words_[w];
+      while (word) {
+        function(w * bit_word::bits + bit_word::count_trailing_zeros(word));
+        word &= word - 1;
+      }
+    }
+  }
+
+  /**
+   * @brief and operator, bits beyond other.size() are treated as 0.
+   * @return word_bitset itself
+   */
+  word_bitset &operator&=(const word_bitset &other) {
+    const std::size_t common = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] &= other.words_[i];
+    std::fill(words_.begin() + common, words_.end(), 0);
+    return *this;
+  }
+
+  /**
+   * @brief or operator, bits beyond size() are ignored.
+   * @return word_bitset itself
+   */
+  word_bitset &operator|=(const word_bitset &other) {
+    const std::size_t common = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] |= other.words_[i];
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief xor operator, bits beyond size() are ignored.
+   * @return word_bitset itself
+   */
+  word_bitset &operator^=(const word_bitset &other) {
+    const std::size_t common = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] ^= other.words_[i];
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief and operator between two word_bitset
+   * @return return new word_bitset
+   */
+  word_bitset operator&(const word_bitset &other) const {
+    word_bitset result(*this);
+    result &= other;
+    return result;
+  }
+
+  /**
+   * @brief or operator between two word_bitset
+   * @return return new word_bitset
+   */
+  word_bitset operator|(const word_bitset &other) const {
+    word_bitset result(*this);
+    result |= other;
+    return result;
+  }
+
+  /**
+   * @brief xor operator between two word_bitset
+   * @return return new word_bitset
+   */
+  word_bitset operator^(const word_bitset &other) const {
+    word_bitset result(*this);
+    result ^= other;
+    return result;
+  }
+
+  /**
+   * @brief Invert every bit.
+   * @return word_bitset itself
+   */
+  word_bitset &flip() {
+    for (auto &word : words_)
+      word = ~word;
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief Fused this &= ~other.
+   * @return word_bitset itself
+   */
+  word_bitset &and_not(const word_bitset &other) {
+    const std::size_t common = std::min(words_.size(), other.words_.size());
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] &= ~other.words_[i];
+    return *this;
+  }
+
+  /**
+   * @brief Fused this |= a & b without a temporary.
+   * @return word_bitset itself
+   */
+  word_bitset &or_and(const word_bitset &a, const word_bitset &b) {
+    const std::size_t common =
+        std::min({words_.size(), a.words_.size(), b.words_.size()});
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] |= a.words_[i] & b.words_[i];
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief Fused this |= a & ~b without a temporary.
+   * @return word_bitset itself
+   */
+  word_bitset &or_and_not(const word_bitset &a, const word_bitset &b) {
+    const std::size_t common =
+        std::min({words_.size(), a.words_.size(), b.words_.size()});
+    for (std::size_t i = 0; i < common; ++i)
+      words_[i] |= a.words_[i] & ~b.words_[i];
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief Fused this |= src << shift without a temporary: bit i of src is
+   * or'ed into bit i + shift, bits moved past size() are dropped.
+   *
+   * Words are written from the top down, so src may be this set itself as in
+   * the subset sum step reachable |= reachable << weight.
+   *
+   * @param src Bitset to shift, may have another size.
+   * @param shift Amount of positions to move towards higher indexes.
+   * @return word_bitset itself
+   */
+  word_bitset &or_shifted(const word_bitset &src, std::size_t shift) {
+    const std::size_t offset = shift / bit_word::bits;
+    const unsigned bit = shift % bit_word::bits;
+    const std::size_t count = src.words_.size();
+    const std::size_t first = offset;
+    std::size_t w = std::min(words_.size(), count + offset + (bit ? 1 : 0));
+    if (count == 0 || first >= w)
+      return *this;
+    const word_type *from = src.words_.data();
+    if (bit == 0) {
+      while (w-- > first)
+        words_[w] |= from[w - offset];
+    } else {
+      // the word above the shifted src only receives its carried out bits
+      if (w - offset > count) {
+        --w;
+        words_[w] |= from[count - 1] >> (bit_word::bits - bit);
+      }
+      while (w-- > first + 1)
+        words_[w] |= (from[w - offset] << bit) |
+                     (from[w - offset - 1] >> (bit_word::bits - bit));
+      words_[first] |= from[0] << bit;
+    }
+    trim();
+    return *this;
+  }
+
+  /**
+   * @brief Population count of this & other without a temporary.
+   * @return Number of bits set in both sets.
+   */
+  std::size_t and_count(const word_bitset &other) const {
+    const std::size_t common = std::min(words_.size(), other.words_.size());
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < common; ++i)
+      total += bit_word::popcount(words_[i] & other.words_[i]);
+    return total;
+  }
+
+  /**
+   * @brief Equality operator, compares size and every bit.
+   */
+  bool operator==(const word_bitset &other) const {
+    return size_ == other.size_ && words_ == other.words_;
+  }
+
+  /**
+   * @brief Inequality operator.
+   */
+  bool operator!=(const word_bitset &other) const { return !(*this == other); }
+
+  /**
+   * @brief Unpack into a dynamic_bitset.
+   * @return New dynamic_bitset with the same bits.
+   */
+  dynamic_bitset<> to_dynamic_bitset() const {
+    std::vector<bool> bits(size_);
+    for_each([&bits](std::size_t index) { bits[index] = true; });
+    return dynamic_bitset<>(std::move(bits));
+  }
+
+  /**
+   * @brief Clear the unused bits of the last word.
+   */
+  void trim() {
+    const std::size_t used = size_ % bit_word::bits;
+    if (used && !words_.empty())
+      words_.back() &= bit_word::low_mask(used);
+  }
+
+private:
+  /**
+   * @brief Throw if a range ending at last leaves the bitset.
+   */
+  void check_range(std::size_t last) const {
+    if (last > size_)
+      throw std::out_of_range("word_bitset range is out of range");
+  }
+
+  /**
+   * @brief Index of the first set bit at or after position.
+   * @return Index of the bit, bit_word::npos if there is none.
+   */
+  std::size_t find_from(std::size_t position) const {
+    if (position >= size_)
+      return bit_word::npos;
+    std::size_t w = position / bit_word::bits;
+    word_type word = words_[w] & ~bit_word::low_mask(position % bit_word::bits);
+    while (true) {
+      if (word)
+        return w * bit_word::bits + bit_word::count_trailing_zeros(word);
+      if (++w == words_.size())
+        return bit_word::npos;
+      word = words_[w];
+    }
+  }
+
+  bit_word::word_vector words_;
+  std::size_t size_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "../Source/bit_arithmetic.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+std::string sample_number(std::size_t bits, std::size_t seed) {
+  std::string number(bits, '0');
+  for (std::size_t i = 0; i < bits; ++i)
+    if (bit_word::mix(seed * 1000003 + i) & 1)
+      number[i] = '1';
+  return number;
+}
+
+// schoolbook binary addition of two equally long strings, modulo 2^size
+std::string reference_add(const std::string &a, const std::string &b) {
+  std::string sum(a.size(), '0');
+  int carry = 0;
+  for (std::size_t i = a.size(); i-- > 0;) {
+    const int digit = (a[i] - '0') + (b[i] - '0') + carry;
+    sum[i] = static_cast<char>('0' + digit % 2);
+    carry = digit / 2;
+  }
+  return sum;
+}
+
+std::string complement(std::string a) {
+  for (auto &c : a)
+    c = c == '1' ? '0' : '1';
+  return a;
+}
+} // namespace
+
+TEST(bit_arithmetic_words, BasicAssertions) {
+  bit_word::word_type a[2] = {~0ULL, 1}, b[2] = {1, 2}, out[2];
+  EXPECT_EQ(0, bit_arithmetic::add_with_carry(out, a, b, 2));
+  EXPECT_EQ(0u, out[0]);
+  EXPECT_EQ(4u, out[1]);
+  EXPECT_EQ(1, bit_arithmetic::sub_with_borrow(out, a, b, 2));
+  EXPECT_EQ(~0ULL - 1, out[0]);
+  EXPECT_EQ(~0ULL, out[1]);
+  EXPECT_LT(bit_arithmetic::compare(a, b, 2), 0);
+  EXPECT_EQ(0, bit_arithmetic::compare(a, a, 2));
+
+  EXPECT_EQ(0, bit_arithmetic::increment(a, 2));
+  EXPECT_EQ(0u, a[0]);
+  EXPECT_EQ(2u, a[1]);
+  bit_arithmetic::negate(a, 2);
+  EXPECT_EQ(0u, a[0]);
+  EXPECT_EQ(~0ULL - 1, a[1]);
+
+  bit_word::word_type ones[2] = {~0ULL, ~0ULL};
+  EXPECT_EQ(1, bit_arithmetic::increment(ones, 2));
+}
+
+TEST(bit_arithmetic_dynamic_bitset, BasicAssertions) {
+  dynamic_bitset<> a("0110"), b("0011");
+  EXPECT_EQ("1001", (a + b).to_string());
+  EXPECT_EQ("0011", (a - b).to_string());
+  EXPECT_EQ("1101", (b - a).to_string());
+  EXPECT_EQ(9u, (a + b).to_ulong());
+
+  // sizes align at the least significant bit
+  dynamic_bitset<> small("1"), wide("0111");
+  EXPECT_EQ("1000", (wide + small).to_string());
+  EXPECT_TRUE(small < wide);
+  EXPECT_TRUE(dynamic_bitset<>("0001") >= small);
+  EXPECT_TRUE(dynamic_bitset<>("0001") <= small);
+  EXPECT_EQ(0, compare_numeric(dynamic_bitset<>("0001"), small));
+  EXPECT_LT(compare_numeric(small, dynamic_bitset<>("0011")), 0);
+  EXPECT_GT(compare_numeric(dynamic_bitset<>("1000"), wide), 0);
+
+  dynamic_bitset<> counter("0111");
+  increment_numeric(counter);
+  EXPECT_EQ("1000", counter.to_string());
+  dynamic_bitset<> wrap("111");
+  EXPECT_EQ("000", increment_numeric(wrap).to_string());
+  dynamic_bitset<> value("0110");
+  EXPECT_EQ("1010", negate_numeric(value).to_string());
+  dynamic_bitset<> zero("000");
+  EXPECT_EQ("000", negate_numeric(zero).to_string());
+
+  dynamic_bitset<> sum("0001");
+  sum += a;
+  sum -= b;
+  EXPECT_EQ("0100", sum.to_string());
+}
+
+TEST(bit_arithmetic_multi_word, BasicAssertions) {
+  for (std::size_t bits : {63u, 64u, 65u, 200u, 1000u}) {
+    const std::string x = sample_number(bits, 1), y = sample_number(bits, 2);
+    dynamic_bitset<> a(x), b(y);
+    EXPECT_EQ(reference_add(x, y), (a + b).to_string());
+    // a - b == a + ~b + 1
+    const std::string one = std::string(bits - 1, '0') + "1";
+    EXPECT_EQ(reference_add(reference_add(x, complement(y)), one),
+              (a - b).to_string());
+    EXPECT_EQ(x < y, a < b);
+    EXPECT_EQ(x > y, a > b);
+
+    dynamic_bitset<> all_ones(std::string(bits, '1'));
+    EXPECT_TRUE(increment_numeric(all_ones).to_string() ==
+                std::string(bits, '0'));
+
+    dynamic_bitset<> negated(x);
+    EXPECT_EQ(reference_add(complement(x), one),
+              negate_numeric(negated).to_string());
+  }
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "../Source/bit_extract.hpp"
+
+namespace {
+bit_word::word_type naive_extract(bit_word::word_type word,
+                                  bit_word::word_type mask) {
+  bit_word::word_type result = 0;
+  for (std::size_t i = 0, k = 0; i < 64; ++i)
+    if ((mask >> i) & 1)
+      result |= ((word >> i) & 1) << k++;
+  return result;
+}
+
+bit_word::word_type naive_deposit(bit_word::word_type word,
+                                  bit_word::word_type mask) {
+  bit_word::word_type result = 0;
+  for (std::size_t i = 0, k = 0; i < 64; ++i)
+    if ((mask >> i) & 1)
+      result |= ((word >> k++) & 1) << i;
+  return result;
+}
+} // namespace
+
+TEST(bit_extract_word, BasicAssertions) {
+  EXPECT_EQ(0x5u, bit_extract::extract(0xF0A5, 0x0F0F) & 0xF);
+  EXPECT_EQ(0xA5u, bit_extract::extract(0xF0A5, 0x00FF));
+  EXPECT_EQ(0x0F0Fu, bit_extract::deposit(0xFF, 0xFF0F) & 0x0F0F);
+  const bit_word::word_type all = ~bit_word::word_type(0);
+  EXPECT_EQ(all, bit_extract::extract_portable(all, all));
+  EXPECT_EQ(all, bit_extract::deposit_portable(all, all));
+  EXPECT_EQ(0u, bit_extract::extract_portable(all, 0));
+
+  for (std::size_t i = 0; i < 2000; ++i) {
+    const bit_word::word_type word = bit_word::mix(2 * i);
+    // sparse, dense and run heavy masks
+    bit_word::word_type mask = bit_word::mix(2 * i + 1);
+    if (i % 3 == 1)
+      mask &= bit_word::mix(i + 7);
+    if (i % 3 == 2)
+      mask = (mask | (mask << 1) | (mask << 2)) & ~(mask >> 5);
+    ASSERT_EQ(naive_extract(word, mask), bit_extract::extract(word, mask));
+    ASSERT_EQ(naive_extract(word, mask),
+              bit_extract::extract_portable(word, mask));
+    ASSERT_EQ(naive_deposit(word, mask), bit_extract::deposit(word, mask));
+    ASSERT_EQ(naive_deposit(word, mask),
+              bit_extract::deposit_portable(word, mask));
+  }
+}
+
+TEST(bit_extract_bitset, BasicAssertions) {
+  dynamic_bitset<> src("10110011");
+  dynamic_bitset<> mask("11001010");
+  EXPECT_EQ("1001", extract(src, mask).to_string());
+  EXPECT_EQ("10000010", deposit(dynamic_bitset<>("1001"), mask).to_string());
+  EXPECT_THROW(extract(src, dynamic_bitset<>("101")), std::invalid_argument);
+  EXPECT_THROW(deposit(src, mask), std::invalid_argument);
+
+  for (std::size_t size : {1u, 63u, 64u, 65u, 300u, 1000u}) {
+    word_bitset x(size), m(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      x.set(i, bit_word::mix(i) & 1);
+      m.set(i, bit_word::mix(i + size) % 3 != 0);
+    }
+    const word_bitset packed = extract(x, m);
+    ASSERT_EQ(m.count(), packed.size());
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      if (m.test(i)) {
+        ASSERT_EQ(x.test(i), packed.test(k++)) << size << " " << i;
+      }
+    }
+    EXPECT_EQ(x & m, deposit(packed, m));
+  }
+}
@@ -0,0 +1,98 @@
+#include "../Source/bit_matrix.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+bit_matrix sample_matrix(std::size_t rows, std::size_t cols,
+                         std::size_t seed) {
+  bit_matrix matrix(rows, cols);
+  for (std::size_t i = 0; i < rows; ++i)
+    for (std::size_t j = 0; j < cols; ++j)
+      matrix.set(i, j, bit_word::mix(seed * 1000003 + i * cols + j) & 1);
+  return matrix;
+}
+
+bit_matrix reference_product(const bit_matrix &a, const bit_matrix &b) {
+  bit_matrix result(a.rows(), b.cols());
+  for (std::size_t i = 0; i < a.rows(); ++i)
+    for (std::size_t j = 0; j < b.cols(); ++j) {
+      bool sum = false;
+      for (std::size_t k = 0; k < a.cols(); ++k)
+        sum ^= a.test(i, k) && b.test(k, j);
+      result.set(i, j, sum);
+    }
+  return result;
+}
+} // namespace
+
+TEST(bit_matrix_rows, BasicAssertions) {
+  std::vector<dynamic_bitset<>> rows;
+  rows.emplace_back("1100");
+  rows.emplace_back("0110");
+  rows.emplace_back("1010");
+  bit_matrix matrix(rows);
+  EXPECT_EQ(3u, matrix.rows());
+  EXPECT_EQ(4u, matrix.cols());
+  EXPECT_TRUE(matrix.test(1, 2));
+  EXPECT_EQ("0110", matrix[1].to_string());
+
+  // the third row is the sum of the first two
+  EXPECT_EQ(2u, matrix.rank());
+  matrix.xor_row(2, 0);
+  EXPECT_EQ("0110", matrix[2].to_string());
+  matrix.swap_rows(0, 2);
+  EXPECT_EQ("1100", matrix[2].to_string());
+
+  bit_matrix reduced(rows);
+  EXPECT_EQ(2u, reduced.eliminate());
+  EXPECT_EQ("1010", reduced[0].to_string());
+  EXPECT_EQ("0110", reduced[1].to_string());
+  EXPECT_TRUE(reduced[2].none());
+
+  EXPECT_EQ(64u, bit_matrix::identity(64).rank());
+  EXPECT_EQ(0u, bit_matrix(5, 70).rank());
+}
+
+TEST(bit_matrix_solve, BasicAssertions) {
+  for (std::size_t n : {5u, 64u, 100u, 200u}) {
+    const bit_matrix a = sample_matrix(n + 3, n, n);
+    word_bitset x(n);
+    for (std::size_t i = 0; i < n; i += 3)
+      x.set(i, true);
+    const word_bitset b = a.multiply(x);
+    word_bitset solution;
+    ASSERT_TRUE(a.solve(b, solution));
+    EXPECT_EQ(b, a.multiply(solution));
+    if (a.rank() == n) {
+      EXPECT_EQ(x, solution);
+    }
+  }
+
+  // x0 + x1 = 1 and x0 + x1 = 0 is inconsistent
+  bit_matrix a(2, 2);
+  a.set(0, 0, true).set(0, 1, true).set(1, 0, true).set(1, 1, true);
+  word_bitset b(2);
+  b.set(0, true);
+  word_bitset x;
+  EXPECT_FALSE(a.solve(b, x));
+
+  dynamic_bitset<> rhs("11");
+  dynamic_bitset<> solution;
+  EXPECT_TRUE(bit_matrix::identity(2).solve(rhs, solution));
+  EXPECT_EQ("11", solution.to_string());
+  EXPECT_THROW(a.solve(word_bitset(3), x), std::invalid_argument);
+}
+
+TEST(bit_matrix_multiply, BasicAssertions) {
+  for (std::size_t n : {1u, 7u, 64u, 130u}) {
+    for (std::size_t m : {9u, 65u, 1100u}) {
+      const bit_matrix a = sample_matrix(33, n, n + m);
+      const bit_matrix b = sample_matrix(n, m, n * m);
+      EXPECT_EQ(reference_product(a, b), a * b);
+    }
+  }
+  const bit_matrix a = sample_matrix(70, 70, 3);
+  EXPECT_EQ(a, a * bit_matrix::identity(70));
+  EXPECT_EQ(a, bit_matrix::identity(70) * a);
+  EXPECT_THROW(a * bit_matrix(3, 3), std::invalid_argument);
+}
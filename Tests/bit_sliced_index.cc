@@ -0,0 +1,72 @@
+#include "../Source/bit_sliced_index.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<std::uint32_t> sample_values() {
+  std::vector<std::uint32_t> values;
+  for (std::uint32_t i = 0; i < 250; ++i)
+    values.push_back((i * 7919u + 13u) % 1000u);
+  return values;
+}
+} // namespace
+
+TEST(bit_sliced_index_decode, BasicAssertions) {
+  const auto values = sample_values();
+  bit_sliced_index<std::uint32_t> index(values);
+  EXPECT_EQ(values.size(), index.size());
+  EXPECT_EQ(10u, index.slice_count());
+  for (std::size_t row = 0; row < values.size(); ++row)
+    EXPECT_EQ(values[row], index.value(row));
+}
+
+TEST(bit_sliced_index_sum, BasicAssertions) {
+  const auto values = sample_values();
+  bit_sliced_index<std::uint32_t> index(values);
+
+  std::uint64_t total = 0, filtered = 0;
+  std::vector<bool> filter(values.size());
+  for (std::size_t row = 0; row < values.size(); ++row) {
+    total += values[row];
+    filter[row] = row % 3 == 0;
+    if (filter[row])
+      filtered += values[row];
+  }
+  EXPECT_EQ(total, index.sum());
+  EXPECT_EQ(filtered, index.sum(dynamic_bitset<>(filter)));
+}
+
+TEST(bit_sliced_index_compare, BasicAssertions) {
+  const auto values = sample_values();
+  bit_sliced_index<std::uint32_t> index(values);
+
+  for (std::uint32_t c : {0u, 1u, 499u, 500u, 998u, 999u, 1023u, 5000u}) {
+    std::string less, less_equal, equal, greater, greater_equal;
+    for (const auto v : values) {
+      less.push_back(v < c ? '1' : '0');
+      less_equal.push_back(v <= c ? '1' : '0');
+      equal.push_back(v == c ? '1' : '0');
+      greater.push_back(v > c ? '1' : '0');
+      greater_equal.push_back(v >= c ? '1' : '0');
+    }
+    EXPECT_EQ(less, index.less(c).to_string());
+    EXPECT_EQ(less_equal, index.less_equal(c).to_string());
+    EXPECT_EQ(equal, index.equal(c).to_string());
+    EXPECT_EQ(greater, index.greater(c).to_string());
+    EXPECT_EQ(greater_equal, index.greater_equal(c).to_string());
+  }
+}
+
+TEST(bit_sliced_index_topk, BasicAssertions) {
+  std::vector<std::uint8_t> values = {5, 9, 1, 9, 3, 7, 7, 7, 0, 2};
+  bit_sliced_index<std::uint8_t> index(values);
+
+  EXPECT_EQ("0101000000", index.topk(2).to_string());
+  EXPECT_EQ("0101011000", index.topk(4).to_string());
+  EXPECT_EQ("1101011100", index.topk(6).to_string());
+  EXPECT_EQ("0000000000", index.topk(0).to_string());
+  EXPECT_EQ("1111111111", index.topk(20).to_string());
+
+  dynamic_bitset<> filter = std::string("1010101011");
+  EXPECT_EQ("1000101000", index.topk(3, filter).to_string());
+}
@@ -0,0 +1,79 @@
+#include "../Source/bit_transpose.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace {
+bit_matrix sample_matrix(std::size_t rows, std::size_t cols,
+                         std::size_t seed) {
+  bit_matrix matrix(rows, cols);
+  for (std::size_t i = 0; i < rows; ++i)
+    for (std::size_t j = 0; j < cols; ++j)
+      matrix.set(i, j, bit_word::mix(seed * 1000003 + i * cols + j) % 3 == 0);
+  return matrix;
+}
+
+void expect_transposed(const bit_word::word_type *block,
+                       const bit_word::word_type *transposed) {
+  for (unsigned i = 0; i < 64; ++i)
+    for (unsigned j = 0; j < 64; ++j)
+      ASSERT_EQ((block[i] >> j) & 1, (transposed[j] >> i) & 1);
+}
+} // namespace
+
+TEST(bit_transpose_blocks, BasicAssertions) {
+  bit_word::word_type block[64], swapped[64];
+  for (unsigned i = 0; i < 64; ++i)
+    block[i] = swapped[i] = bit_word::mix(i);
+  bit_transpose::block64_swap(swapped);
+  expect_transposed(block, swapped);
+  bit_transpose::block64_swap(swapped);
+  EXPECT_TRUE(std::equal(block, block + 64, swapped));
+
+#if defined(__SSE2__) || defined(_M_X64)
+  bit_word::word_type masked[64];
+  std::copy(block, block + 64, masked);
+  bit_transpose::block64_movemask(masked);
+  expect_transposed(block, masked);
+#endif
+}
+
+TEST(bit_transpose_matrix, BasicAssertions) {
+  for (std::size_t rows : {1u, 63u, 64u, 100u, 300u})
+    for (std::size_t cols : {1u, 64u, 65u, 129u}) {
+      const bit_matrix matrix = sample_matrix(rows, cols, rows + cols);
+      const bit_matrix result = transpose(matrix);
+      ASSERT_EQ(cols, result.rows());
+      ASSERT_EQ(rows, result.cols());
+      for (std::size_t i = 0; i < rows; ++i)
+        for (std::size_t j = 0; j < cols; ++j)
+          ASSERT_EQ(matrix.test(i, j), result.test(j, i));
+      EXPECT_EQ(matrix, transpose(result));
+    }
+}
+
+TEST(bit_transpose_rows, BasicAssertions) {
+  std::vector<dynamic_bitset<>> rows;
+  rows.emplace_back("110");
+  rows.emplace_back("011");
+  const auto columns = transpose(rows);
+  ASSERT_EQ(3u, columns.size());
+  EXPECT_EQ("10", columns[0].to_string());
+  EXPECT_EQ("11", columns[1].to_string());
+  EXPECT_EQ("01", columns[2].to_string());
+
+  for (bitset_layout layout :
+       {bitset_layout::row_major, bitset_layout::interleaved}) {
+    bitset_array array(70, 130, layout);
+    for (std::size_t i = 0; i < 70; ++i)
+      for (std::size_t j = 0; j < 130; ++j)
+        array[i].set(j, bit_word::mix(i * 130 + j) & 1);
+    const bitset_array result = transpose(array);
+    ASSERT_EQ(130u, result.rows());
+    ASSERT_EQ(70u, result.bits());
+    EXPECT_EQ(layout, result.layout());
+    for (std::size_t i = 0; i < 70; ++i)
+      for (std::size_t j = 0; j < 130; ++j)
+        ASSERT_EQ(array[i][j], result[j][i]);
+  }
+}
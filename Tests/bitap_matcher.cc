@@ -0,0 +1,90 @@
+#include "../Source/bitap_matcher.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace {
+std::string sample_text(std::size_t length, std::size_t seed,
+                        std::size_t alphabet) {
+  std::string text(length, 'a');
+  for (std::size_t i = 0; i < length; ++i)
+    text[i] = static_cast<char>('a' + bit_word::mix(seed * 1000003 + i) %
+                                          alphabet);
+  return text;
+}
+
+// smallest edit distance of pattern against a substring ending at every end
+std::vector<bitap_match> reference(const std::string &pattern,
+                                   const std::string &text,
+                                   std::size_t errors) {
+  const std::size_t m = pattern.size();
+  std::vector<std::size_t> column(m + 1), next(m + 1);
+  for (std::size_t i = 0; i <= m; ++i)
+    column[i] = i;
+  std::vector<bitap_match> result;
+  for (std::size_t j = 0; j < text.size(); ++j) {
+    next[0] = 0;
+    for (std::size_t i = 1; i <= m; ++i)
+      next[i] = std::min({column[i] + 1, next[i - 1] + 1,
+                          column[i - 1] + (pattern[i - 1] != text[j])});
+    if (next[m] <= errors)
+      result.push_back({j + 1, next[m]});
+    column.swap(next);
+  }
+  return result;
+}
+} // namespace
+
+TEST(bitap_matcher_exact, BasicAssertions) {
+  bitap_matcher short_pattern("aba");
+  EXPECT_EQ(3u, short_pattern.size());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 6}),
+            short_pattern.find_all("ababaxaba"));
+  EXPECT_EQ(2u, short_pattern.find("ababaxaba", 1));
+  EXPECT_EQ(bit_word::npos, short_pattern.find("abba"));
+  EXPECT_FALSE(short_pattern.contains("ab"));
+
+  // patterns spanning several words with a carry between them
+  const std::string text = sample_text(5000, 1, 2);
+  for (std::size_t length : {63u, 64u, 65u, 130u, 200u}) {
+    for (std::size_t start : {0u, 777u, 4800u}) {
+      const std::string pattern = text.substr(start, length);
+      bitap_matcher matcher(pattern);
+      std::vector<std::size_t> expected;
+      for (std::size_t p = text.find(pattern); p != std::string::npos;
+           p = text.find(pattern, p + 1))
+        expected.push_back(p);
+      EXPECT_EQ(expected, matcher.find_all(text));
+      EXPECT_EQ(expected.front(), matcher.find(text));
+    }
+  }
+
+  EXPECT_THROW(bitap_matcher(""), std::invalid_argument);
+}
+
+TEST(bitap_matcher_approximate, BasicAssertions) {
+  bitap_matcher matcher("needle");
+  EXPECT_TRUE(matcher.contains("a nedle here", 1));
+  EXPECT_FALSE(matcher.contains("a nedle here"));
+  EXPECT_EQ(reference("needle", "a nedle, a neeedle", 2),
+            matcher.find_all("a nedle, a neeedle", 2));
+
+  const std::string text = sample_text(3000, 2, 4);
+  for (std::size_t length : {20u, 70u, 150u}) {
+    std::string pattern = text.substr(1000, length);
+    // plant a few edits so occurrences need errors
+    pattern[length / 3] = 'z';
+    pattern.erase(length / 2, 1);
+    pattern.insert(2 * length / 3, "y");
+    bitap_matcher long_matcher(pattern);
+    for (std::size_t errors : {1u, 3u, 5u})
+      EXPECT_EQ(reference(pattern, text, errors),
+                long_matcher.find_all(text, errors));
+  }
+
+  // more errors than a word can hold
+  const std::string pattern = text.substr(100, 300);
+  EXPECT_EQ(reference(pattern, text, 70),
+            bitap_matcher(pattern).find_all(text, 70));
+  EXPECT_THROW(matcher.find_all("x", 6), std::invalid_argument);
+}
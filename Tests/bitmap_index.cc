@@ -0,0 +1,76 @@
+#include "../Source/bitmap_index.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<int> sample_column() {
+  std::vector<int> column;
+  for (int i = 0; i < 300; ++i)
+    column.push_back((i * 37 + 11) % 23 - 5);
+  return column;
+}
+
+template <typename Predicate>
+std::string expected_rows(const std::vector<int> &column, Predicate predicate) {
+  std::string rows;
+  for (const auto value : column)
+    rows.push_back(predicate(value) ? '1' : '0');
+  return rows;
+}
+
+void check_queries(bitmap_encoding encoding) {
+  const auto column = sample_column();
+  bitmap_index<int> index(column, encoding);
+  EXPECT_EQ(column.size(), index.size());
+  EXPECT_EQ(23u, index.cardinality());
+
+  for (int v = -7; v <= 19; ++v) {
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x == v; }),
+              index.equal(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x != v; }),
+              index.not_equal(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x < v; }),
+              index.less(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x <= v; }),
+              index.less_equal(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x > v; }),
+              index.greater(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x >= v; }),
+              index.greater_equal(v).to_string());
+    EXPECT_EQ(expected_rows(column, [v](int x) { return x >= v && x <= v + 6; }),
+              index.between(v, v + 6).to_string());
+  }
+
+  EXPECT_EQ(expected_rows(column, [](int x) { return x == -5 || x == 3; }),
+            index.in({-5, 3, 100}).to_string());
+  EXPECT_TRUE(index.between(4, 2).none());
+}
+} // namespace
+
+TEST(bitmap_index_equality, BasicAssertions) {
+  check_queries(bitmap_encoding::equality);
+  bitmap_index<int> index(sample_column(), bitmap_encoding::equality);
+  EXPECT_EQ(23u, index.bitmap_count());
+}
+
+TEST(bitmap_index_range, BasicAssertions) {
+  check_queries(bitmap_encoding::range);
+  bitmap_index<int> index(sample_column(), bitmap_encoding::range);
+  EXPECT_EQ(22u, index.bitmap_count());
+}
+
+TEST(bitmap_index_bit_sliced, BasicAssertions) {
+  check_queries(bitmap_encoding::bit_sliced);
+  bitmap_index<int> index(sample_column(), bitmap_encoding::bit_sliced);
+  EXPECT_EQ(5u, index.bitmap_count());
+}
+
+TEST(bitmap_index_single_value, BasicAssertions) {
+  for (auto encoding : {bitmap_encoding::equality, bitmap_encoding::range,
+                        bitmap_encoding::bit_sliced}) {
+    bitmap_index<int> index({7, 7, 7}, encoding);
+    EXPECT_EQ("111", index.equal(7).to_string());
+    EXPECT_EQ("000", index.less(7).to_string());
+    EXPECT_EQ("111", index.greater_equal(7).to_string());
+  }
+}
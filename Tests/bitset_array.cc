@@ -0,0 +1,100 @@
+#include "../Source/bitset_array.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+void fill(bitset_array &array) {
+  for (std::size_t row = 0; row < array.rows(); ++row)
+    for (std::size_t i = row; i < array.bits(); i += row + 1)
+      array[row].set(i, true);
+}
+} // namespace
+
+TEST(bitset_array_views, BasicAssertions) {
+  for (auto layout : {bitset_layout::row_major, bitset_layout::interleaved}) {
+    bitset_array array(4, 70, layout);
+    EXPECT_EQ(2u, array.words_per_row());
+    array[1].set(0, true).set(69, true);
+    EXPECT_TRUE(array[1][69]);
+    EXPECT_EQ(2u, array[1].count());
+    EXPECT_TRUE(array[0].none());
+
+    const bitset_array &constant = array;
+    const_bitset_view view = constant[1];
+    EXPECT_EQ("1" + std::string(68, '0') + "1", view.to_string());
+    EXPECT_EQ(view.to_string(), view.to_dynamic_bitset().to_string());
+
+    array[2].set(true);
+    EXPECT_TRUE(array[2].all());
+    EXPECT_EQ(70u, array[2].count());
+    array[2].reset();
+    EXPECT_TRUE(array[2].none());
+
+    dynamic_bitset<> source = std::string("1011");
+    array[3].assign(word_bitset(source));
+    EXPECT_EQ(3u, array[3].count());
+    EXPECT_EQ(word_bitset(source).data()[0], array.word(3, 0));
+
+    array[3].assign(word_bitset(200, true));
+    EXPECT_TRUE(array[3].all());
+    EXPECT_EQ(70u, array[3].count());
+    EXPECT_EQ(bit_word::low_mask(6), array.word(3, 1));
+    array[3].assign(word_bitset(source));
+    EXPECT_EQ(3u, array[3].count());
+  }
+}
+
+TEST(bitset_array_elementwise, BasicAssertions) {
+  for (auto layout : {bitset_layout::row_major, bitset_layout::interleaved}) {
+    bitset_array a(5, 100, layout), b(5, 100, layout);
+    fill(a);
+    for (std::size_t row = 0; row < 5; ++row)
+      b[row].set(true);
+    for (std::size_t row = 0; row < 5; ++row)
+      b[row].set(row, false);
+
+    const auto c = a & b;
+    const auto d = a ^ b;
+    for (std::size_t row = 0; row < 5; ++row) {
+      EXPECT_EQ((a[row].to_word_bitset() & b[row].to_word_bitset()),
+                c[row].to_word_bitset());
+      EXPECT_EQ((a[row].to_word_bitset() ^ b[row].to_word_bitset()),
+                d[row].to_word_bitset());
+      EXPECT_FALSE(c[row][row]);
+    }
+    a.and_not(b);
+    EXPECT_EQ(5u, a.row_any().count());
+    EXPECT_EQ(5u, a.column_or().count());
+
+    bitset_array other(5, 100, bitset_layout::row_major == layout
+                                   ? bitset_layout::interleaved
+                                   : bitset_layout::row_major);
+    EXPECT_THROW(a |= other, std::invalid_argument);
+  }
+}
+
+TEST(bitset_array_reductions, BasicAssertions) {
+  bitset_array row_major(6, 130, bitset_layout::row_major);
+  bitset_array interleaved(6, 130, bitset_layout::interleaved);
+  fill(row_major);
+  fill(interleaved);
+
+  const auto counts = row_major.row_counts();
+  EXPECT_EQ(counts, interleaved.row_counts());
+  for (std::size_t row = 0; row < 6; ++row)
+    EXPECT_EQ(row_major[row].count(), counts[row]);
+
+  const auto columns = row_major.column_counts();
+  EXPECT_EQ(columns, interleaved.column_counts());
+  for (std::size_t i = 0; i < 130; ++i) {
+    std::size_t expected = 0;
+    for (std::size_t row = 0; row < 6; ++row)
+      expected += row_major[row][i];
+    EXPECT_EQ(expected, columns[i]);
+  }
+
+  EXPECT_EQ(row_major.column_or(), interleaved.column_or());
+  EXPECT_EQ(row_major.column_and(), interleaved.column_and());
+  EXPECT_TRUE(row_major.column_and().test(59));
+  EXPECT_FALSE(row_major.column_and().test(58));
+}
@@ -0,0 +1,120 @@
+#include "../Source/bitset_graph.hpp"
+
+#include <deque>
+#include <gtest/gtest.h>
+
+namespace {
+bitset_graph sample_graph(std::size_t vertices, std::size_t percent,
+                          bool directed, std::size_t seed) {
+  bitset_graph graph(vertices, directed);
+  for (std::size_t u = 0; u < vertices; ++u)
+    for (std::size_t v = directed ? 0 : u + 1; v < vertices; ++v)
+      if (u != v && bit_word::mix(seed * 1000003 + u * vertices + v) % 100 <
+                        percent)
+        graph.add_edge(u, v);
+  return graph;
+}
+
+std::vector<std::size_t> reference_bfs(const bitset_graph &graph,
+                                       std::size_t source) {
+  std::vector<std::size_t> distance(graph.size(), bit_word::npos);
+  std::deque<std::size_t> queue = {source};
+  distance[source] = 0;
+  while (!queue.empty()) {
+    const std::size_t u = queue.front();
+    queue.pop_front();
+    for (std::size_t v = 0; v < graph.size(); ++v)
+      if (graph.has_edge(u, v) && distance[v] == bit_word::npos) {
+        distance[v] = distance[u] + 1;
+        queue.push_back(v);
+      }
+  }
+  return distance;
+}
+} // namespace
+
+TEST(bitset_graph_edges, BasicAssertions) {
+  bitset_graph graph(5);
+  graph.add_edge(0, 1).add_edge(1, 2).add_edge(2, 2);
+  EXPECT_TRUE(graph.has_edge(1, 0));
+  EXPECT_EQ(2u, graph.degree(1));
+  EXPECT_EQ(3u, graph.edge_count());
+  EXPECT_EQ("10100", graph.neighbors(1).to_string());
+  graph.add_edge(0, 1).remove_edge(2, 1);
+  EXPECT_EQ(2u, graph.edge_count());
+  EXPECT_FALSE(graph.has_edge(1, 2));
+
+  bitset_graph directed(3, true);
+  directed.add_edge(0, 1);
+  EXPECT_TRUE(directed.directed());
+  EXPECT_FALSE(directed.has_edge(1, 0));
+  EXPECT_EQ(1u, directed.edge_count());
+}
+
+TEST(bitset_graph_bfs, BasicAssertions) {
+  // a path keeps the search top-down
+  bitset_graph path(200);
+  for (std::size_t v = 0; v + 1 < 150; ++v)
+    path.add_edge(v, v + 1);
+  const auto distance = path.bfs(0);
+  EXPECT_EQ(149u, distance[149]);
+  EXPECT_EQ(bit_word::npos, distance[150]);
+
+  // dense graphs switch to bottom-up steps
+  for (bool directed : {false, true})
+    for (std::size_t percent : {1u, 5u, 40u}) {
+      const bitset_graph graph = sample_graph(300, percent, directed, percent);
+      EXPECT_EQ(reference_bfs(graph, 7), graph.bfs(7));
+    }
+
+  // edge changes after a search reach the transposed matrix
+  bitset_graph graph = sample_graph(300, 40, true, 3);
+  EXPECT_EQ(reference_bfs(graph, 7), graph.bfs(7));
+  for (std::size_t v = 0; v < 300; v += 2)
+    graph.remove_edge(7, v).add_edge(v, 7);
+  EXPECT_EQ(reference_bfs(graph, 7), graph.bfs(7));
+}
+
+TEST(bitset_graph_triangles, BasicAssertions) {
+  bitset_graph k4(4);
+  for (std::size_t u = 0; u < 4; ++u)
+    for (std::size_t v = u + 1; v < 4; ++v)
+      k4.add_edge(u, v);
+  EXPECT_EQ(4u, k4.triangle_count());
+
+  const bitset_graph graph = sample_graph(150, 30, false, 3);
+  std::size_t expected = 0;
+  for (std::size_t u = 0; u < 150; ++u)
+    for (std::size_t v = u + 1; v < 150; ++v)
+      for (std::size_t w = v + 1; w < 150; ++w)
+        expected += graph.has_edge(u, v) && graph.has_edge(v, w) &&
+                    graph.has_edge(u, w);
+  EXPECT_EQ(expected, graph.triangle_count());
+  EXPECT_THROW(bitset_graph(3, true).triangle_count(), std::invalid_argument);
+}
+
+TEST(bitset_graph_closure, BasicAssertions) {
+  bitset_graph chain(4, true);
+  chain.add_edge(0, 1).add_edge(1, 2).add_edge(3, 0);
+  const bitset_graph reach = chain.transitive_closure();
+  EXPECT_TRUE(reach.has_edge(0, 2));
+  EXPECT_TRUE(reach.has_edge(3, 2));
+  EXPECT_FALSE(reach.has_edge(2, 0));
+  EXPECT_FALSE(reach.has_edge(0, 0));
+  EXPECT_EQ(3u, reach.degree(3));
+
+  const bitset_graph graph = sample_graph(130, 2, true, 9);
+  const bitset_graph closure = graph.transitive_closure();
+  for (std::size_t u = 0; u < 130; u += 13) {
+    // v is reachable from u when it is at distance >= 1 from a successor
+    std::vector<bool> expected(130, false);
+    for (std::size_t s = 0; s < 130; ++s)
+      if (graph.has_edge(u, s)) {
+        const auto distance = graph.bfs(s);
+        for (std::size_t v = 0; v < 130; ++v)
+          expected[v] = expected[v] || distance[v] != bit_word::npos;
+      }
+    for (std::size_t v = 0; v < 130; ++v)
+      EXPECT_EQ(expected[v], closure.has_edge(u, v));
+  }
+}
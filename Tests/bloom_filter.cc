@@ -0,0 +1,98 @@
+#include "../Source/bloom_filter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+TEST(bloom_filter_no_false_negatives, BasicAssertions) {
+  bloom_filter<std::uint64_t> filter(10000, 0.01);
+  EXPECT_EQ(filter.block_count() * 512, filter.size());
+  for (std::uint64_t i = 0; i < 10000; ++i)
+    filter.insert(i * 7);
+  for (std::uint64_t i = 0; i < 10000; ++i)
+    EXPECT_TRUE(filter.contains(i * 7));
+}
+
+TEST(bloom_filter_false_positive_rate, BasicAssertions) {
+  bloom_filter<std::uint64_t> filter(50000, 0.01);
+  for (std::uint64_t i = 0; i < 50000; ++i)
+    filter.insert(i);
+
+  std::size_t false_positives = 0;
+  for (std::uint64_t i = 1000000; i < 1100000; ++i)
+    false_positives += filter.contains(i);
+  EXPECT_LT(false_positives, 2000u);
+
+  for (double rate : {0.0, 1.0, 1.5, -0.1, std::nan("")}) {
+    EXPECT_THROW(bloom_filter<std::uint64_t>(100, rate),
+                 std::invalid_argument);
+    EXPECT_THROW(counting_bloom_filter<std::uint64_t>(100, rate),
+                 std::invalid_argument);
+  }
+}
+
+TEST(bloom_filter_batch, BasicAssertions) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; ++i)
+    keys.push_back("key" + std::to_string(i));
+
+  bloom_filter<std::string> single(200), batch(200);
+  for (const auto &key : keys)
+    single.insert(key);
+  batch.insert_many(keys);
+  EXPECT_EQ(single.bits(), batch.bits());
+
+  std::vector<std::string> probes = {"key3", "nope", "key99", "key100"};
+  auto found = batch.contains_many(probes);
+  EXPECT_EQ(4u, found.size());
+  for (std::size_t i = 0; i < probes.size(); ++i)
+    EXPECT_EQ(batch.contains(probes[i]), found[i]);
+  EXPECT_TRUE(found[0]);
+  EXPECT_TRUE(found[2]);
+}
+
+TEST(bloom_filter_union_intersection, BasicAssertions) {
+  bloom_filter<int> a(1000), b(1000);
+  for (int i = 0; i < 500; ++i)
+    a.insert(i);
+  for (int i = 250; i < 750; ++i)
+    b.insert(i);
+
+  auto both = a | b;
+  for (int i = 0; i < 750; ++i)
+    EXPECT_TRUE(both.contains(i));
+
+  auto common = a & b;
+  for (int i = 250; i < 500; ++i)
+    EXPECT_TRUE(common.contains(i));
+
+  bloom_filter<int> other(100000);
+  EXPECT_THROW(a |= other, std::invalid_argument);
+
+  a.clear();
+  EXPECT_TRUE(a.bits().none());
+}
+
+TEST(counting_bloom_filter, BasicAssertions) {
+  counting_bloom_filter<int> filter(1000);
+  for (int i = 0; i < 1000; ++i)
+    filter.insert(i);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_TRUE(filter.contains(i));
+
+  for (int i = 0; i < 500; ++i)
+    EXPECT_TRUE(filter.remove(i));
+  for (int i = 500; i < 1000; ++i)
+    EXPECT_TRUE(filter.contains(i));
+
+  std::size_t still_present = 0;
+  for (int i = 0; i < 500; ++i)
+    still_present += filter.contains(i);
+  EXPECT_LT(still_present, 50u);
+
+  auto plain = filter.to_bloom_filter();
+  EXPECT_EQ(filter.block_count(), plain.block_count());
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(filter.contains(i), plain.contains(i));
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../Source/cellular_automaton.hpp"
+
+namespace {
+word_bitset random_cells(std::size_t size, std::size_t seed) {
+  word_bitset cells(size);
+  for (std::size_t i = 0; i < size; ++i)
+    cells.set(i, bit_word::mix(seed * 1000003 + i) & 1);
+  return cells;
+}
+
+word_bitset naive_elementary(const word_bitset &cells, unsigned rule,
+                             bool wrap) {
+  const std::size_t n = cells.size();
+  word_bitset result(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool left = i > 0 ? cells.test(i - 1) : wrap && cells.test(n - 1);
+    const bool right = i + 1 < n ? cells.test(i + 1) : wrap && cells.test(0);
+    result.set(i, (rule >> (left * 4 + cells.test(i) * 2 + right)) & 1);
+  }
+  return result;
+}
+
+bit_matrix naive_life(const bit_matrix &grid, bool wrap) {
+  const long rows = static_cast<long>(grid.rows());
+  const long cols = static_cast<long>(grid.cols());
+  bit_matrix result(grid.rows(), grid.cols());
+  for (long i = 0; i < rows; ++i)
+    for (long j = 0; j < cols; ++j) {
+      int count = 0;
+      for (long di = -1; di <= 1; ++di)
+        for (long dj = -1; dj <= 1; ++dj) {
+          long r = i + di, c = j + dj;
+          if (di == 0 && dj == 0)
+            continue;
+          if (wrap) {
+            r = (r + rows) % rows;
+            c = (c + cols) % cols;
+          } else if (r < 0 || r >= rows || c < 0 || c >= cols) {
+            continue;
+          }
+          count += grid.test(r, c);
+        }
+      result.set(i, j, count == 3 || (count == 2 && grid.test(i, j)));
+    }
+  return result;
+}
+
+std::string row_string(const word_bitset &cells) {
+  std::string text;
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    text += cells.test(i) ? '#' : '.';
+  return text;
+}
+} // namespace
+
+TEST(cellular_automaton_rule30, BasicAssertions) {
+  word_bitset cells(9);
+  cells.set(4, true);
+  cells = elementary_step<30>(cells);
+  EXPECT_EQ("...###...", row_string(cells));
+  cells = elementary_step<30>(cells);
+  EXPECT_EQ("..##..#..", row_string(cells));
+  cells = elementary_step<30>(cells);
+  EXPECT_EQ(".##.####.", row_string(cells));
+
+  // the runtime rule and the dynamic_bitset overload agree
+  dynamic_bitset<> seed("000010000");
+  EXPECT_EQ("000111000", elementary_step(seed, 30).to_string());
+  EXPECT_EQ(elementary_step<110>(cells, true),
+            elementary_step(cells, 110, true));
+}
+
+TEST(cellular_automaton_elementary, BasicAssertions) {
+  for (std::size_t size : {1u, 5u, 63u, 64u, 65u, 200u}) {
+    const word_bitset cells = random_cells(size, size);
+    for (bool wrap : {false, true}) {
+      EXPECT_EQ(naive_elementary(cells, 30, wrap),
+                elementary_step<30>(cells, wrap));
+      EXPECT_EQ(naive_elementary(cells, 110, wrap),
+                elementary_step<110>(cells, wrap));
+      for (unsigned rule = 0; rule < 256; rule += 17)
+        EXPECT_EQ(naive_elementary(cells, rule, wrap),
+                  elementary_step(cells, rule, wrap));
+    }
+  }
+}
+
+TEST(cellular_automaton_patterns, BasicAssertions) {
+  // blinker has period 2, block is still
+  bit_matrix grid(6, 6);
+  grid.set(2, 1, true).set(2, 2, true).set(2, 3, true);
+  const bit_matrix vertical = life_step(grid);
+  bit_matrix expected(6, 6);
+  expected.set(1, 2, true).set(2, 2, true).set(3, 2, true);
+  EXPECT_EQ(expected, vertical);
+  EXPECT_EQ(grid, life_step(vertical));
+
+  bit_matrix block(4, 4);
+  block.set(1, 1, true).set(1, 2, true).set(2, 1, true).set(2, 2, true);
+  EXPECT_EQ(block, life_step(block));
+
+  // a glider moves one cell diagonally every 4 generations, on a 10 x 70
+  // torus it is back after 70 moves
+  bit_matrix torus(10, 70);
+  torus.set(0, 1, true).set(1, 2, true).set(2, 0, true).set(2, 1, true).set(
+      2, 2, true);
+  bit_matrix state = torus;
+  for (int generation = 0; generation < 4 * 70; ++generation)
+    state = life_step(state, true);
+  EXPECT_EQ(torus, state);
+}
+
+TEST(cellular_automaton_life, BasicAssertions) {
+  for (std::size_t cols : {1u, 3u, 64u, 65u, 130u}) {
+    bit_matrix grid(37, cols);
+    for (std::size_t i = 0; i < grid.rows(); ++i)
+      for (std::size_t j = 0; j < cols; ++j)
+        grid.set(i, j, bit_word::mix(i * 131 + j) % 3 == 0);
+    for (bool wrap : {false, true}) {
+      bit_matrix expected = grid, state = grid;
+      for (int generation = 0; generation < 5; ++generation) {
+        expected = naive_life(expected, wrap);
+        state = life_step(state, wrap, 1 + generation);
+        ASSERT_EQ(expected, state) << cols << " " << wrap << " " << generation;
+      }
+    }
+  }
+
+  std::vector<dynamic_bitset<>> rows;
+  rows.emplace_back("01000");
+  rows.emplace_back("01000");
+  rows.emplace_back("01000");
+  const std::vector<dynamic_bitset<>> next = life_step(rows);
+  EXPECT_EQ("00000", next[0].to_string());
+  EXPECT_EQ("11100", next[1].to_string());
+  EXPECT_EQ("00000", next[2].to_string());
+}
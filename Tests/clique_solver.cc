@@ -0,0 +1,84 @@
+#include "../Source/clique_solver.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+bitset_graph sample_graph(std::size_t vertices, std::size_t percent,
+                          std::size_t seed) {
+  bitset_graph graph(vertices);
+  for (std::size_t u = 0; u < vertices; ++u)
+    for (std::size_t v = u + 1; v < vertices; ++v)
+      if (bit_word::mix(seed * 1000003 + u * vertices + v) % 100 < percent)
+        graph.add_edge(u, v);
+  return graph;
+}
+
+bool is_clique(const bitset_graph &graph,
+               const std::vector<std::size_t> &vertices) {
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+    for (std::size_t j = i + 1; j < vertices.size(); ++j)
+      if (!graph.has_edge(vertices[i], vertices[j]))
+        return false;
+  return true;
+}
+
+// largest clique by enumerating every subset of a small graph
+std::size_t brute_force_clique(const bitset_graph &graph) {
+  std::size_t best = 0;
+  for (std::size_t mask = 0; mask < (std::size_t(1) << graph.size()); ++mask) {
+    std::vector<std::size_t> vertices;
+    for (std::size_t v = 0; v < graph.size(); ++v)
+      if ((mask >> v) & 1)
+        vertices.push_back(v);
+    if (vertices.size() > best && is_clique(graph, vertices))
+      best = vertices.size();
+  }
+  return best;
+}
+} // namespace
+
+TEST(clique_solver_small, BasicAssertions) {
+  bitset_graph graph(6);
+  graph.add_edge(0, 1).add_edge(1, 2).add_edge(0, 2).add_edge(2, 3);
+  graph.add_edge(3, 4);
+  EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}), maximum_clique(graph));
+  // {0, 3, 5}, {1, 3, 5}, ... every independent set has at most 3 vertices
+  EXPECT_EQ(3u, maximum_independent_set(graph).size());
+
+  EXPECT_TRUE(maximum_clique(bitset_graph(0)).empty());
+  EXPECT_EQ(1u, maximum_clique(bitset_graph(5)).size());
+  EXPECT_THROW(clique_solver(bitset_graph(3, true)), std::invalid_argument);
+
+  std::vector<dynamic_bitset<>> rows;
+  rows.emplace_back("011");
+  rows.emplace_back("000");
+  rows.emplace_back("000");
+  // edges 0 - 1 and 0 - 2, given in one direction only
+  const auto pair = clique_solver(rows).solve();
+  ASSERT_EQ(2u, pair.size());
+  EXPECT_EQ(0u, pair[0]);
+}
+
+TEST(clique_solver_random, BasicAssertions) {
+  for (std::size_t percent : {20u, 50u, 80u}) {
+    const bitset_graph graph = sample_graph(16, percent, percent);
+    const auto clique = maximum_clique(graph);
+    EXPECT_TRUE(is_clique(graph, clique));
+    EXPECT_EQ(brute_force_clique(graph), clique.size());
+  }
+
+  // a planted clique of 12 vertices in a sparse graph spanning several words
+  bitset_graph graph = sample_graph(300, 10, 7);
+  std::vector<std::size_t> planted;
+  for (std::size_t v = 5; v < 300; v += 25)
+    planted.push_back(v);
+  for (std::size_t i = 0; i < planted.size(); ++i)
+    for (std::size_t j = i + 1; j < planted.size(); ++j)
+      graph.add_edge(planted[i], planted[j]);
+  clique_solver solver(graph);
+  const auto clique = solver.solve();
+  EXPECT_EQ(planted, clique);
+  EXPECT_GT(solver.nodes(), 0u);
+  // solving again reuses the pool
+  EXPECT_EQ(planted, solver.solve());
+}
@@ -87,6 +87,13 @@ TEST(left_shift_operator, BasicAssertions) {
   dynamic_bitset<> y = std::string("10101");
   y <<= 2;
   EXPECT_EQ(expected, y.get());
+
+  // the last bits read only from inside the vector
+  dynamic_bitset<> z = std::string("11111");
+  z <<= 4;
+  EXPECT_EQ(std::vector<bool>({1, 0, 0, 0, 0}), z.get());
+  z <<= 0;
+  EXPECT_EQ(std::vector<bool>({1, 0, 0, 0, 0}), z.get());
 }
 
 TEST(right_shift_operator, BasicAssertions) {
@@ -95,6 +102,11 @@ TEST(right_shift_operator, BasicAssertions) {
   dynamic_bitset<> y = std::string("10101");
   y >>= 2;
   EXPECT_EQ(expected, y.get());
+
+  y >>= 0;
+  EXPECT_EQ(expected, y.get());
+  y >>= 4;
+  EXPECT_EQ(std::vector<bool>({0, 0, 0, 0, 0}), y.get());
 }
 
 TEST(input_stream, BasicAssertions) {
@@ -0,0 +1,113 @@
+#include "../Source/hamming_index.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+word_bitset random_code(std::size_t bits, std::uint64_t seed) {
+  word_bitset code(bits);
+  for (std::size_t w = 0; w < code.word_count(); ++w)
+    code.data()[w] = bit_word::mix(seed * 1000003 + w);
+  code.trim();
+  return code;
+}
+
+std::vector<hamming_match> reference_knn(const std::vector<word_bitset> &codes,
+                                         const word_bitset &query,
+                                         std::size_t k) {
+  std::vector<hamming_match> all;
+  for (std::size_t id = 0; id < codes.size(); ++id)
+    all.push_back({id, (codes[id] ^ query).count()});
+  std::sort(all.begin(), all.end());
+  all.resize(std::min(k, all.size()));
+  return all;
+}
+
+// codes clustered around a few centers so neighbours are close
+std::vector<word_bitset> clustered_codes(std::size_t bits, std::size_t count) {
+  std::vector<word_bitset> codes;
+  for (std::size_t i = 0; i < count; ++i) {
+    word_bitset code = random_code(bits, i % 5);
+    for (std::size_t f = 0; f < 1 + i % 7; ++f)
+      code.set(bit_word::mix(i * 31 + f) % bits,
+               !code.test(bit_word::mix(i * 31 + f) % bits));
+    codes.push_back(code);
+  }
+  return codes;
+}
+} // namespace
+
+TEST(hamming_index_layout, BasicAssertions) {
+  hamming_index index(300);
+  EXPECT_EQ(8u, index.stride());
+  dynamic_bitset<> code = std::string(300, '1');
+  EXPECT_EQ(0u, index.add(code));
+  EXPECT_EQ(1u, index.add(word_bitset(300)));
+  EXPECT_EQ(2u, index.size());
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(index.row(1)) % 64);
+  EXPECT_EQ(300u, index.distance(1, word_bitset(code)));
+  EXPECT_THROW(index.add(word_bitset(10)), std::invalid_argument);
+  EXPECT_THROW(index.distance(0, word_bitset(5000)), std::invalid_argument);
+  EXPECT_THROW(index.distance(2, word_bitset(300)), std::out_of_range);
+}
+
+TEST(hamming_index_knn_scan, BasicAssertions) {
+  for (std::size_t bits : {256u, 1000u, 4096u}) {
+    const auto codes = clustered_codes(bits, 200);
+    hamming_index index(bits);
+    for (const auto &code : codes)
+      index.add(code);
+
+    for (std::uint64_t q = 0; q < 5; ++q) {
+      const auto query = random_code(bits, q);
+      EXPECT_EQ(reference_knn(codes, query, 10), index.knn(query, 10));
+    }
+    EXPECT_EQ(200u, index.knn(codes[0], 1000).size());
+    EXPECT_TRUE(index.knn(codes[0], 0).empty());
+  }
+}
+
+TEST(hamming_index_multi_index, BasicAssertions) {
+  const std::size_t bits = 256;
+  const auto codes = clustered_codes(bits, 300);
+  hamming_index index(bits);
+  for (std::size_t i = 0; i < 150; ++i)
+    index.add(codes[i]);
+  index.build_multi_index(16);
+  for (std::size_t i = 150; i < codes.size(); ++i)
+    index.add(codes[i]);
+  EXPECT_TRUE(index.multi_indexed());
+
+  for (std::uint64_t q = 0; q < 5; ++q) {
+    const auto query = random_code(bits, q);
+    EXPECT_EQ(reference_knn(codes, query, 7), index.knn(query, 7));
+  }
+  // far away query falls back to seeing every row
+  const auto far = random_code(bits, 99);
+  EXPECT_EQ(reference_knn(codes, far, 3), index.knn(far, 3));
+
+  const auto within = index.radius_search(codes[3], 6);
+  for (const auto &match : within)
+    EXPECT_LE(match.distance, 6u);
+  EXPECT_FALSE(within.empty());
+
+  hamming_index empty(bits);
+  empty.build_multi_index(16);
+  EXPECT_TRUE(empty.knn(random_code(bits, 1), 5).empty());
+  EXPECT_TRUE(empty.radius_search(random_code(bits, 1), 6).empty());
+}
+
+TEST(hamming_index_batch, BasicAssertions) {
+  const std::size_t bits = 512;
+  const auto codes = clustered_codes(bits, 100);
+  hamming_index index(bits);
+  for (const auto &code : codes)
+    index.add(code);
+
+  std::vector<word_bitset> queries;
+  for (std::uint64_t q = 0; q < 9; ++q)
+    queries.push_back(random_code(bits, q));
+  const auto results = index.knn_batch(queries, 4, 3);
+  ASSERT_EQ(queries.size(), results.size());
+  for (std::size_t i = 0; i < queries.size(); ++i)
+    EXPECT_EQ(index.knn(queries[i], 4), results[i]);
+}
@@ -0,0 +1,65 @@
+#include "../Source/linear_counter.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(linear_counter_estimate, BasicAssertions) {
+  linear_counter<std::uint64_t> counter(1 << 16);
+  EXPECT_EQ(0.0, counter.estimate());
+
+  for (std::uint64_t i = 0; i < 20000; ++i) {
+    counter.insert(i);
+    counter.insert(i);
+  }
+  EXPECT_NEAR(20000.0, counter.estimate(), 400.0);
+  EXPECT_FALSE(counter.saturated());
+
+  counter.clear();
+  EXPECT_EQ(0.0, counter.estimate());
+}
+
+TEST(linear_counter_bits_for, BasicAssertions) {
+  const std::size_t bits = linear_counter<int>::bits_for(50000, 0.01);
+  EXPECT_GT(bits, 10000u);
+  EXPECT_LT(bits, 100000u);
+  for (double error : {0.0, -0.5, 1.0, std::nan("")})
+    EXPECT_THROW(linear_counter<int>::bits_for(1000, error),
+                 std::invalid_argument);
+
+  linear_counter<int> counter(bits);
+  std::vector<int> keys;
+  for (int i = 0; i < 50000; ++i)
+    keys.push_back(i * 31);
+  counter.insert_many(keys);
+  EXPECT_NEAR(50000.0, counter.estimate(), 50000 * 0.04);
+}
+
+TEST(linear_counter_merge, BasicAssertions) {
+  std::vector<linear_counter<int>> shards(4, linear_counter<int>(1 << 15));
+  for (int i = 0; i < 12000; ++i)
+    shards[i % 4].insert(i % 9000);
+
+  linear_counter<int> merged(1 << 15);
+  for (const auto &shard : shards)
+    merged |= shard;
+  EXPECT_NEAR(9000.0, merged.estimate(), 250.0);
+
+  linear_counter<int> a(1 << 15), b(1 << 15);
+  for (int i = 0; i < 6000; ++i)
+    a.insert(i);
+  for (int i = 3000; i < 9000; ++i)
+    b.insert(i);
+  EXPECT_NEAR(9000.0, (a | b).estimate(), 250.0);
+  EXPECT_NEAR(3000.0, a.intersection_estimate(b), 300.0);
+
+  linear_counter<int> other(100);
+  EXPECT_THROW(a |= other, std::invalid_argument);
+}
+
+TEST(linear_counter_saturated, BasicAssertions) {
+  linear_counter<int> counter(64);
+  for (int i = 0; i < 10000; ++i)
+    counter.insert(i);
+  EXPECT_TRUE(counter.saturated());
+  EXPECT_NEAR(64 * std::log(64.0), counter.estimate(), 1e-9);
+}
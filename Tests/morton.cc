@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+
+#include "../Source/morton.hpp"
+
+TEST(morton_codes, BasicAssertions) {
+  EXPECT_EQ(0u, morton::encode(0, 0));
+  EXPECT_EQ(1u, morton::encode(1, 0));
+  EXPECT_EQ(2u, morton::encode(0, 1));
+  EXPECT_EQ(0xFu, morton::encode(3, 3));
+  EXPECT_EQ(0x4u, morton::encode(0, 0, 1));
+  EXPECT_EQ(0x3Fu, morton::encode(3, 3, 3));
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    const bit_word::word_type a = bit_word::mix(3 * i) & 0xFFFFFFFFULL;
+    const bit_word::word_type b = bit_word::mix(3 * i + 1) & 0xFFFFFFFFULL;
+    bit_word::word_type code = 0;
+    for (std::size_t bit = 0; bit < 32; ++bit)
+      code |= (((a >> bit) & 1) << (2 * bit)) |
+              (((b >> bit) & 1) << (2 * bit + 1));
+    ASSERT_EQ(code, morton::encode(a, b));
+    bit_word::word_type x, y, z;
+    morton::decode(code, x, y);
+    ASSERT_EQ(a, x);
+    ASSERT_EQ(b, y);
+
+    const bit_word::word_type c = bit_word::mix(3 * i + 2);
+    morton::decode(morton::encode(a & 0x1FFFFF, b & 0x1FFFFF, c & 0x1FFFFF), x,
+                   y, z);
+    ASSERT_EQ(a & 0x1FFFFF, x);
+    ASSERT_EQ(b & 0x1FFFFF, y);
+    ASSERT_EQ(c & 0x1FFFFF, z);
+  }
+}
+
+TEST(morton_interleave, BasicAssertions) {
+  EXPECT_EQ("1001", interleave(dynamic_bitset<>("10"), dynamic_bitset<>("01"))
+                        .to_string());
+  EXPECT_EQ("100001",
+            interleave(dynamic_bitset<>("10"), dynamic_bitset<>("00"),
+                       dynamic_bitset<>("01"))
+                .to_string());
+  EXPECT_THROW(interleave(word_bitset(3), word_bitset(4)),
+               std::invalid_argument);
+
+  for (std::size_t size : {1u, 20u, 21u, 22u, 32u, 63u, 64u, 65u, 500u}) {
+    word_bitset x(size), y(size), z(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      x.set(i, bit_word::mix(i) & 1);
+      y.set(i, bit_word::mix(i) & 2);
+      z.set(i, bit_word::mix(i) & 4);
+    }
+    const word_bitset two = interleave(x, y);
+    const word_bitset three = interleave(x, y, z);
+    for (std::size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(x.test(i), two.test(2 * i));
+      ASSERT_EQ(y.test(i), two.test(2 * i + 1));
+      ASSERT_EQ(x.test(i), three.test(3 * i));
+      ASSERT_EQ(y.test(i), three.test(3 * i + 1));
+      ASSERT_EQ(z.test(i), three.test(3 * i + 2));
+    }
+    EXPECT_EQ(x.count() + y.count(), two.count());
+    EXPECT_EQ(x.count() + y.count() + z.count(), three.count());
+
+    word_bitset a, b, c;
+    deinterleave(two, a, b);
+    EXPECT_EQ(x, a);
+    EXPECT_EQ(y, b);
+    deinterleave(three, a, b, c);
+    EXPECT_EQ(x, a);
+    EXPECT_EQ(y, b);
+    EXPECT_EQ(z, c);
+  }
+}
+
+TEST(morton_spatial_2d, BasicAssertions) {
+  spatial_bitset<2> grid(50);
+  EXPECT_EQ(64u, grid.side());
+  EXPECT_EQ(4096u, grid.size());
+
+  // the aligned 4 x 4 square at (4, 8) is one range
+  const auto square = grid.ranges({{4, 8}}, {{8, 12}});
+  ASSERT_EQ(1u, square.size());
+  EXPECT_EQ(16u, square[0].second - square[0].first);
+
+  grid.set({{3, 5}}, {{20, 9}}, true);
+  EXPECT_EQ(17u * 4, grid.count());
+  EXPECT_TRUE(grid.test({{3, 5}}));
+  EXPECT_FALSE(grid.test({{20, 5}}));
+  EXPECT_EQ(4u, grid.count({{0, 0}}, {{4, 64}}));
+  EXPECT_TRUE(grid.any({{19, 8}}, {{30, 30}}));
+  EXPECT_FALSE(grid.any({{21, 0}}, {{64, 64}}));
+
+  // box queries agree with a scan of every cell
+  spatial_bitset<2> random(64);
+  for (std::uint32_t x = 0; x < 64; ++x)
+    for (std::uint32_t y = 0; y < 64; ++y)
+      random.set({{x, y}}, bit_word::mix(x * 64 + y) % 5 == 0);
+  for (std::size_t q = 0; q < 50; ++q) {
+    const std::uint32_t x0 = bit_word::mix(4 * q) % 64;
+    const std::uint32_t y0 = bit_word::mix(4 * q + 1) % 64;
+    const std::uint32_t x1 = x0 + bit_word::mix(4 * q + 2) % (65 - x0);
+    const std::uint32_t y1 = y0 + bit_word::mix(4 * q + 3) % (65 - y0);
+    std::set<std::size_t> expected;
+    for (std::uint32_t x = x0; x < x1; ++x)
+      for (std::uint32_t y = y0; y < y1; ++y)
+        if (random.test({{x, y}}))
+          expected.insert(spatial_bitset<2>::code({{x, y}}));
+    std::set<std::size_t> found;
+    random.for_each({{x0, y0}}, {{x1, y1}},
+                    [&](const spatial_bitset<2>::point &p) {
+                      ASSERT_TRUE(p[0] >= x0 && p[0] < x1);
+                      ASSERT_TRUE(p[1] >= y0 && p[1] < y1);
+                      found.insert(spatial_bitset<2>::code(p));
+                    });
+    EXPECT_EQ(expected, found);
+    EXPECT_EQ(expected.size(), random.count({{x0, y0}}, {{x1, y1}}));
+    EXPECT_EQ(!expected.empty(), random.any({{x0, y0}}, {{x1, y1}}));
+  }
+}
+
+TEST(morton_spatial_3d, BasicAssertions) {
+  spatial_bitset<3> grid(16);
+  EXPECT_EQ(4096u, grid.size());
+  grid.set({{1, 2, 3}}, {{9, 10, 11}}, true);
+  EXPECT_EQ(512u, grid.count());
+  EXPECT_EQ(1u, grid.count({{0, 0, 0}}, {{2, 3, 4}}));
+  EXPECT_FALSE(grid.any({{9, 0, 0}}, {{16, 16, 16}}));
+  const spatial_bitset<3>::point p = spatial_bitset<3>::cell(
+      spatial_bitset<3>::code({{5, 6, 7}}));
+  EXPECT_EQ(5u, p[0]);
+  EXPECT_EQ(6u, p[1]);
+  EXPECT_EQ(7u, p[2]);
+
+  std::size_t visited = 0;
+  grid.for_each({{0, 0, 0}}, {{16, 16, 4}},
+                [&](const spatial_bitset<3>::point &cell) {
+                  EXPECT_EQ(3u, cell[2]);
+                  ++visited;
+                });
+  EXPECT_EQ(64u, visited);
+}
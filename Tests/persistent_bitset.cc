@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../Source/persistent_bitset.hpp"
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace {
+std::string fresh_path(const std::string &name) {
+  const std::string path = ::testing::TempDir() + "persistent_" + name;
+  std::remove(path.c_str());
+  std::remove((path + ".log").c_str());
+  return path;
+}
+
+std::string contents(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+void overwrite(const std::string &path, const std::string &data) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << data;
+}
+} // namespace
+
+TEST(persistent_bitset_reopen, BasicAssertions) {
+  const std::string path = fresh_path("reopen");
+  word_bitset expected(1000);
+  {
+    persistent_bitset bits(path, 1000);
+    EXPECT_TRUE(bits.bits().none());
+    bits.set(3).set(999).set_range(100, 300, true).reset(200);
+    expected.set(3, true).set(999, true).set_range(100, 300, true);
+    expected.reset(200);
+    EXPECT_EQ(4u, bits.pending());
+    bits.commit();
+    EXPECT_EQ(0u, bits.pending());
+    EXPECT_EQ(8u * (2 + 12), bits.log_bytes());
+    EXPECT_THROW(bits.set(1000), std::out_of_range);
+  }
+  // the image is stale, the log holds the batch
+  EXPECT_EQ(8u * (2 + 16), contents(path).size());
+  EXPECT_EQ(8u * (2 + 12), contents(path + ".log").size());
+  {
+    persistent_bitset bits(path, 1000);
+    EXPECT_EQ(expected, bits.bits());
+    // opening checkpoints the replayed log
+    EXPECT_EQ(0u, bits.log_bytes());
+    EXPECT_TRUE(contents(path + ".log").empty());
+  }
+  persistent_bitset bits(path, 1000);
+  EXPECT_EQ(expected, bits.bits());
+
+  EXPECT_THROW(persistent_bitset(path, 999), std::invalid_argument);
+  const std::string garbage = fresh_path("garbage");
+  overwrite(garbage, "not an image");
+  EXPECT_THROW(persistent_bitset(garbage, 10), std::runtime_error);
+}
+
+TEST(persistent_bitset_torn_log, BasicAssertions) {
+  const std::string path = fresh_path("torn");
+  word_bitset committed(500);
+  {
+    persistent_bitset bits(path, 500, 1000);
+    bits.set(10).set(20).commit();
+    bits.set_range(30, 40, true).commit();
+    committed.set(10, true).set(20, true).set_range(30, 40, true);
+    bits.set(50).commit();
+  }
+  // cut the last batch as a crash during its append would
+  const std::string log = contents(path + ".log");
+  overwrite(path + ".log", log.substr(0, log.size() - 5));
+  {
+    persistent_bitset bits(path, 500);
+    EXPECT_EQ(committed, bits.bits());
+  }
+  // a damaged batch stops the replay as well
+  {
+    persistent_bitset bits(path, 500, 1000);
+    bits.set(60).commit();
+    bits.set(70).commit();
+  }
+  std::string damaged = contents(path + ".log");
+  damaged[damaged.size() - 1] ^= 1;
+  overwrite(path + ".log", damaged);
+  persistent_bitset bits(path, 500);
+  committed.set(60, true);
+  EXPECT_EQ(committed, bits.bits());
+}
+
+TEST(persistent_bitset_group_commit, BasicAssertions) {
+  const std::string path = fresh_path("group");
+  word_bitset expected(100000);
+  {
+    persistent_bitset bits(path, 100000, 10, 8 * 1000);
+    for (std::size_t i = 0; i < 25; ++i) {
+      bits.set(i * 7);
+      expected.set(i * 7, true);
+    }
+    // two groups of 10 records are in the log
+    EXPECT_EQ(5u, bits.pending());
+    EXPECT_EQ(2u * 8 * (2 + 30), bits.log_bytes());
+
+    // the log stays below the checkpoint size
+    for (std::size_t i = 0; i < 2000; ++i) {
+      bits.set(bit_word::mix(i) % 100000, i % 4 != 0);
+      expected.set(bit_word::mix(i) % 100000, i % 4 != 0);
+      ASSERT_LT(bits.log_bytes(), 8u * 1000);
+    }
+  }
+  persistent_bitset bits(path, 100000);
+  EXPECT_EQ(expected, bits.bits());
+}
+
+#if !defined(_WIN32)
+TEST(persistent_bitset_failed_commit, BasicAssertions) {
+  const std::string path = fresh_path("failed");
+  word_bitset expected(1000);
+  {
+    persistent_bitset bits(path, 1000, 1 << 20);
+    bits.set(1).set(2).commit();
+    expected.set(1, true).set(2, true);
+    const std::size_t committed = bits.log_bytes();
+
+    // a file size limit makes the next append fail halfway
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    rlimit limited = saved;
+    limited.rlim_cur = 4096;
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limited);
+    for (std::size_t i = 0; i < 500; ++i) {
+      bits.set(i + 100);
+      expected.set(i + 100, true);
+    }
+    EXPECT_THROW(bits.commit(), std::runtime_error);
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, handler);
+
+    // the torn batch is gone and the retry lands right behind the last one
+    EXPECT_EQ(committed, contents(path + ".log").size());
+    EXPECT_EQ(500u, bits.pending());
+    bits.commit();
+    bits.set(999).commit();
+    expected.set(999, true);
+  }
+  persistent_bitset bits(path, 1000);
+  EXPECT_EQ(expected, bits.bits());
+}
+#endif
@@ -0,0 +1,118 @@
+#include "../Source/posting_engine.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+const std::size_t documents = 1000;
+
+// term t occurs in every document divisible by its step
+const std::vector<std::size_t> steps = {2, 3, 5, 7, 97, 211, 1001};
+
+posting_engine sample_engine() {
+  posting_engine engine(documents);
+  for (const auto step : steps) {
+    std::vector<bool> bits(documents);
+    for (std::size_t d = 0; d < documents; d += step)
+      bits[d] = true;
+    engine.add_term(dynamic_bitset<>(bits));
+  }
+  return engine;
+}
+
+template <typename Predicate> std::string expected_documents(Predicate p) {
+  std::string result;
+  for (std::size_t d = 0; d < documents; ++d)
+    result.push_back(p(d) ? '1' : '0');
+  return result;
+}
+} // namespace
+
+TEST(posting_engine_terms, BasicAssertions) {
+  auto engine = sample_engine();
+  EXPECT_EQ(steps.size(), engine.term_count());
+  EXPECT_EQ(500u, engine.frequency(0));
+  EXPECT_EQ(1u, engine.frequency(6));
+  EXPECT_EQ(expected_documents([](std::size_t d) { return d % 3 == 0; }),
+            engine.evaluate(posting_query::term(1)).to_string());
+}
+
+TEST(posting_engine_and, BasicAssertions) {
+  auto engine = sample_engine();
+  auto t = posting_query::term;
+
+  // dense accumulator
+  auto query = t(0) & t(1) & t(2);
+  EXPECT_EQ(posting_query::kind::all_of, query.type());
+  EXPECT_EQ(3u, query.children().size());
+  EXPECT_EQ(expected_documents([](std::size_t d) { return d % 30 == 0; }),
+            engine.evaluate(query).to_string());
+
+  // sparse candidates galloped and probed
+  EXPECT_EQ(expected_documents([](std::size_t d) { return d % 194 == 0; }),
+            engine.evaluate(t(0) & t(4)).to_string());
+  EXPECT_EQ(expected_documents([](std::size_t d) { return d % 20467 == 0; }),
+            engine.evaluate(t(4) & t(5)).to_string());
+  EXPECT_EQ(expected_documents(
+                [](std::size_t d) { return d % 97 == 0 && d % 2 != 0; }),
+            engine.evaluate(t(4) & ~t(0)).to_string());
+}
+
+TEST(posting_engine_or_not, BasicAssertions) {
+  auto engine = sample_engine();
+  auto t = posting_query::term;
+
+  EXPECT_EQ(expected_documents(
+                [](std::size_t d) { return d % 5 == 0 || d % 7 == 0; }),
+            engine.evaluate(t(2) | t(3)).to_string());
+  EXPECT_EQ(expected_documents([](std::size_t d) { return d % 2 != 0; }),
+            engine.evaluate(~t(0)).to_string());
+  EXPECT_EQ(posting_query::kind::term, (~~t(0)).type());
+
+  auto query = (t(0) | t(4)) & ~(t(1) | t(2)) & ~t(3);
+  EXPECT_EQ(expected_documents([](std::size_t d) {
+              return (d % 2 == 0 || d % 97 == 0) && d % 3 != 0 &&
+                     d % 5 != 0 && d % 7 != 0;
+            }),
+            engine.evaluate(query).to_string());
+
+  EXPECT_EQ(expected_documents([](std::size_t d) {
+              return d % 2 != 0 && d % 3 != 0;
+            }),
+            engine.evaluate(~t(0) & ~t(1)).to_string());
+}
+
+TEST(posting_engine_estimate, BasicAssertions) {
+  auto engine = sample_engine();
+  auto t = posting_query::term;
+  // small engines bound inner nodes by the frequencies of their terms
+  EXPECT_EQ(5u, engine.estimate(t(5) & t(0)));
+  EXPECT_EQ(700u, engine.estimate(t(0) | t(2)));
+  EXPECT_EQ(500u, engine.estimate(~t(0)));
+  EXPECT_EQ(5u, engine.estimate((t(0) | t(2)) & t(5)));
+  EXPECT_EQ(1000u, engine.estimate(t(0) | t(0) | ~t(6)));
+  EXPECT_TRUE(engine.evaluate(t(6) & t(5) & t(0)).any());
+  EXPECT_TRUE(engine.evaluate(t(6) & ~t(0)).none());
+}
+
+TEST(posting_engine_sampled_plan, BasicAssertions) {
+  const std::size_t large = 1 << 22;
+  posting_engine engine(large, 0.02);
+  for (const auto step : {2u, 3u, 1000u}) {
+    word_bitset bits(large);
+    for (std::size_t d = 0; d < large; d += step)
+      bits.set(d, true);
+    engine.add_term(std::move(bits));
+  }
+  auto t = posting_query::term;
+
+  const double exact = static_cast<double>(large / 6 + 1);
+  const double estimated = static_cast<double>(engine.estimate(t(0) & t(1)));
+  EXPECT_NEAR(exact, estimated, 0.02 * large);
+
+  auto query = (t(0) & t(1)) & (t(2) | ~t(0));
+  word_bitset result = engine.evaluate_words(query);
+  EXPECT_EQ(large / 3000 + 1, result.count());
+  for (std::size_t d = result.find_first(); d != bit_word::npos;
+       d = result.find_next(d))
+    EXPECT_EQ(0u, d % 3000);
+}
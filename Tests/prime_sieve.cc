@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "../Source/prime_sieve.hpp"
+
+TEST(prime_sieve_small, BasicAssertions) {
+  prime_sieve sieve(30);
+  const std::vector<std::size_t> expected = {2,  3,  5,  7,  11,
+                                             13, 17, 19, 23, 29};
+  EXPECT_EQ(expected, sieve.primes());
+  EXPECT_EQ(10u, sieve.count());
+  EXPECT_FALSE(sieve.is_prime(0));
+  EXPECT_FALSE(sieve.is_prime(1));
+  EXPECT_TRUE(sieve.is_prime(2));
+  EXPECT_TRUE(sieve.is_prime(29));
+  EXPECT_FALSE(sieve.is_prime(25));
+  EXPECT_EQ(0u, sieve.pi(1));
+  EXPECT_EQ(1u, sieve.pi(2));
+  EXPECT_EQ(4u, sieve.pi(10));
+  EXPECT_EQ(5u, sieve.pi(12));
+
+  EXPECT_EQ(0u, prime_sieve(0).count());
+  EXPECT_EQ(0u, prime_sieve(1).count());
+  EXPECT_EQ(1u, prime_sieve(2).count());
+  EXPECT_EQ(2u, prime_sieve(3).count());
+}
+
+TEST(prime_sieve_naive, BasicAssertions) {
+  // crosses several segments and compares with trial division
+  const std::size_t limit = 3 * prime_sieve::segment_bits * 2 + 123;
+  prime_sieve sieve(limit);
+  std::vector<bool> composite(limit + 1, false);
+  for (std::size_t p = 2; p * p <= limit; ++p)
+    if (!composite[p])
+      for (std::size_t m = p * p; m <= limit; m += p)
+        composite[m] = true;
+  std::size_t count = 0;
+  for (std::size_t n = 2; n <= limit; ++n) {
+    ASSERT_EQ(!composite[n], sieve.is_prime(n)) << n;
+    count += !composite[n];
+  }
+  EXPECT_EQ(count, sieve.count());
+}
+
+TEST(prime_sieve_pi, BasicAssertions) {
+  prime_sieve sieve(10000000);
+  EXPECT_EQ(25u, sieve.pi(100));
+  EXPECT_EQ(168u, sieve.pi(1000));
+  EXPECT_EQ(78498u, sieve.pi(1000000));
+  EXPECT_EQ(664579u, sieve.count());
+}
+
+TEST(prime_sieve_threads, BasicAssertions) {
+  const prime_sieve serial(5000000, 1);
+  const prime_sieve parallel(5000000, 4);
+  EXPECT_EQ(serial.odds(), parallel.odds());
+  EXPECT_EQ(348513u, parallel.count());
+  EXPECT_EQ(348513u, prime_count(5000000, 0));
+}
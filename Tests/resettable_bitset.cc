@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "../Source/resettable_bitset.hpp"
+
+TEST(resettable_bitset_basic, BasicAssertions) {
+  resettable_bitset visited(1000);
+  EXPECT_EQ(1000u, visited.size());
+  EXPECT_TRUE(visited.none());
+  EXPECT_FALSE(visited.test_and_set(5));
+  EXPECT_TRUE(visited.test_and_set(5));
+  visited.set(6).set(700).set(999);
+  EXPECT_EQ(4u, visited.count());
+  EXPECT_EQ(3u, visited.touched_words());
+
+  // a word that is emptied and set again is listed once
+  visited.reset(700);
+  visited.set(701);
+  EXPECT_EQ(3u, visited.touched_words());
+  EXPECT_EQ(4u, visited.count());
+
+  std::vector<std::size_t> bits;
+  visited.for_each([&bits](std::size_t i) { bits.push_back(i); });
+  EXPECT_EQ((std::vector<std::size_t>{5, 6, 701, 999}), bits);
+  EXPECT_EQ(4u, visited.to_word_bitset().count());
+
+  visited.reset();
+  EXPECT_TRUE(visited.none());
+  EXPECT_EQ(0u, visited.touched_words());
+  EXPECT_FALSE(visited.test(5));
+  EXPECT_FALSE(visited.test_and_set(999));
+  EXPECT_EQ(1u, visited.touched_words());
+}
+
+TEST(resettable_bitset_rounds, BasicAssertions) {
+  // sparse and dense rounds, the latter take the full fill path
+  resettable_bitset set(5000);
+  for (std::size_t round = 0; round < 20; ++round) {
+    const std::size_t amount = round % 2 ? 3000 : 20;
+    word_bitset expected(5000);
+    for (std::size_t k = 0; k < amount; ++k) {
+      const std::size_t i = bit_word::mix(round * 10000 + k) % 5000;
+      set.set(i);
+      expected.set(i, true);
+    }
+    ASSERT_EQ(expected, set.to_word_bitset());
+    ASSERT_EQ(expected.count(), set.count());
+    set.reset();
+    ASSERT_TRUE(set.to_word_bitset().none());
+  }
+}
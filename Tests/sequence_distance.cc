@@ -0,0 +1,78 @@
+#include "../Source/sequence_distance.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+std::string sample_text(std::size_t length, std::size_t seed,
+                        std::size_t alphabet) {
+  std::string text(length, 'a');
+  for (std::size_t i = 0; i < length; ++i)
+    text[i] = static_cast<char>('a' + bit_word::mix(seed * 1000003 + i) %
+                                          alphabet);
+  return text;
+}
+
+std::size_t reference_edit(const std::string &a, const std::string &b) {
+  std::vector<std::size_t> row(b.size() + 1), next(b.size() + 1);
+  for (std::size_t j = 0; j <= b.size(); ++j)
+    row[j] = j;
+  for (std::size_t i = 1; i <= a.size(); ++i) {
+    next[0] = i;
+    for (std::size_t j = 1; j <= b.size(); ++j)
+      next[j] = std::min({row[j] + 1, next[j - 1] + 1,
+                          row[j - 1] + (a[i - 1] != b[j - 1])});
+    row.swap(next);
+  }
+  return row[b.size()];
+}
+
+std::size_t reference_lcs(const std::string &a, const std::string &b) {
+  std::vector<std::size_t> row(b.size() + 1, 0), next(b.size() + 1, 0);
+  for (std::size_t i = 1; i <= a.size(); ++i) {
+    for (std::size_t j = 1; j <= b.size(); ++j)
+      next[j] = a[i - 1] == b[j - 1] ? row[j - 1] + 1
+                                     : std::max(row[j], next[j - 1]);
+    row.swap(next);
+  }
+  return row[b.size()];
+}
+} // namespace
+
+TEST(sequence_distance_small, BasicAssertions) {
+  EXPECT_EQ(3u, edit_distance("kitten", "sitting"));
+  EXPECT_EQ(0u, edit_distance("same", "same"));
+  EXPECT_EQ(4u, edit_distance("", "abcd"));
+  EXPECT_EQ(4u, edit_distance("abcd", ""));
+  EXPECT_EQ(4u, lcs_length("ABCBDAB", "BDCABA"));
+  EXPECT_EQ(0u, lcs_length("", "abc"));
+
+  sequence_pattern pattern("kitten");
+  EXPECT_EQ(6u, pattern.size());
+  EXPECT_EQ(3u, pattern.edit_distance("sitting"));
+  EXPECT_EQ(6u, pattern.edit_distance(""));
+}
+
+TEST(sequence_distance_multi_word, BasicAssertions) {
+  for (std::size_t alphabet : {2u, 4u, 26u}) {
+    for (std::size_t length : {63u, 64u, 65u, 200u, 700u}) {
+      const std::string a = sample_text(length, alphabet, alphabet);
+      std::string b = a;
+      // mutate a copy so the strings stay related
+      for (std::size_t i = 0; i < b.size(); i += 9)
+        b[i] = static_cast<char>('a' + (b[i] - 'a' + 1) % alphabet);
+      b.erase(b.size() / 3, 5);
+      b.insert(b.size() / 2, "xyz");
+      const std::string unrelated = sample_text(length / 2 + 7, 99, alphabet);
+      for (const std::string &other : {b, unrelated}) {
+        EXPECT_EQ(reference_edit(a, other), edit_distance(a, other));
+        EXPECT_EQ(reference_edit(a, other),
+                  sequence_pattern(other).edit_distance(a));
+        EXPECT_EQ(reference_lcs(a, other), lcs_length(a, other));
+        EXPECT_EQ(reference_lcs(a, other),
+                  sequence_pattern(other).lcs_length(a));
+      }
+    }
+  }
+}
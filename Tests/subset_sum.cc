@@ -0,0 +1,39 @@
+#include "../Source/subset_sum.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<bool> reference_sums(const std::vector<std::size_t> &weights,
+                                 std::size_t capacity) {
+  std::vector<bool> reachable(capacity + 1, false);
+  reachable[0] = true;
+  for (std::size_t weight : weights)
+    for (std::size_t s = capacity + 1; s-- > weight;)
+      if (reachable[s - weight])
+        reachable[s] = true;
+  return reachable;
+}
+} // namespace
+
+TEST(subset_sum, BasicAssertions) {
+  const std::vector<std::size_t> weights = {3, 34, 4, 12, 5, 2};
+  EXPECT_TRUE(subset_sum(weights, 9));
+  EXPECT_FALSE(subset_sum(weights, 30 + 34 + 1));
+  EXPECT_TRUE(subset_sum(weights, 0));
+  EXPECT_EQ(60u, max_subset_sum(weights, 61));
+  EXPECT_EQ(0u, max_subset_sum({7, 9}, 5));
+
+  // repeated weights go through binary splitting
+  std::vector<std::size_t> many;
+  for (std::size_t i = 0; i < 200; ++i)
+    many.push_back(1 + bit_word::mix(i) % 40);
+  for (std::size_t i = 0; i < 37; ++i)
+    many.push_back(97);
+  for (std::size_t capacity : {1u, 63u, 640u, 5000u}) {
+    const word_bitset sums = subset_sums(many, capacity);
+    const std::vector<bool> expected = reference_sums(many, capacity);
+    ASSERT_EQ(capacity + 1, sums.size());
+    for (std::size_t s = 0; s <= capacity; ++s)
+      EXPECT_EQ(expected[s], sums.test(s)) << s;
+  }
+}
@@ -0,0 +1,65 @@
+#include "../Source/ternary.hpp"
+
+#include <gtest/gtest.h>
+#include <utility>
+
+namespace {
+std::uint64_t reference(unsigned table, std::uint64_t a, std::uint64_t b,
+                        std::uint64_t c) {
+  std::uint64_t result = 0;
+  for (unsigned i = 0; i < 64; ++i) {
+    const unsigned index = (((a >> i) & 1) << 2) | (((b >> i) & 1) << 1) |
+                           ((c >> i) & 1);
+    result |= std::uint64_t((table >> index) & 1) << i;
+  }
+  return result;
+}
+
+template <std::size_t... Tables>
+void check_tables(std::index_sequence<Tables...>) {
+  const std::uint64_t a = bit_word::mix(1), b = bit_word::mix(2),
+                      c = bit_word::mix(3);
+  const std::uint64_t got[] = {ternary_logic::word<Tables>(a, b, c)...};
+  for (unsigned table = 0; table < sizeof...(Tables); ++table)
+    EXPECT_EQ(reference(table, a, b, c), got[table]) << table;
+}
+
+word_bitset sample(std::size_t bits, std::size_t seed) {
+  word_bitset set(bits);
+  for (std::size_t i = 0; i < bits; ++i)
+    if (bit_word::mix(seed * 1000003 + i) & 1)
+      set.set(i, true);
+  return set;
+}
+} // namespace
+
+TEST(ternary_word_tables, BasicAssertions) {
+  check_tables(std::make_index_sequence<256>());
+}
+
+TEST(ternary_bitsets, BasicAssertions) {
+  const std::size_t bits = 1000;
+  const auto a = sample(bits, 1), b = sample(bits, 2), c = sample(bits, 3);
+
+  EXPECT_EQ((a & b) | (a & c) | (b & c), majority(a, b, c));
+  EXPECT_EQ(a ^ b ^ c, ternary<0x96>(a, b, c));
+  word_bitset expected = a;
+  expected.and_not(b);
+  EXPECT_EQ(expected, and_not(a, b));
+
+  word_bitset not_mask = a;
+  not_mask.flip();
+  EXPECT_EQ((b & not_mask) | (c & a), blend(a, b, c));
+
+  // constant tables keep the bits past size cleared
+  const auto ones = ternary<0xFF>(a, b, c);
+  EXPECT_EQ(bits, ones.count());
+  EXPECT_TRUE(ones.all());
+  EXPECT_TRUE(ternary<0x00>(a, b, c).none());
+}
+
+TEST(ternary_dynamic_bitset, BasicAssertions) {
+  dynamic_bitset<> a("1100"), b("1010"), c("0110");
+  EXPECT_EQ("1110", ternary<0xE8>(a, b, c).to_string());
+  EXPECT_EQ("0000", ternary<0x96>(a, b, c).to_string());
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <sstream>
+
+#include "../Source/tracked_bitset.hpp"
+
+TEST(tracked_bitset_delta, BasicAssertions) {
+  tracked_bitset primary(1000);
+  EXPECT_EQ(0u, primary.dirty_words());
+  EXPECT_TRUE(primary.delta().empty());
+
+  primary.set(3).set(64).set(130).set(999);
+  primary.set_range(300, 520, true);
+  primary.reset(400);
+  EXPECT_EQ(9u, primary.dirty_words());
+
+  // words 0 to 2 and 4 to 8 merge into runs
+  const bitset_delta delta = primary.checkpoint();
+  ASSERT_EQ(3u, delta.runs.size());
+  EXPECT_EQ(0u, delta.runs[0].first);
+  EXPECT_EQ(3u, delta.runs[0].count);
+  EXPECT_EQ(4u, delta.runs[1].first);
+  EXPECT_EQ(5u, delta.runs[1].count);
+  EXPECT_EQ(15u, delta.runs[2].first);
+  EXPECT_EQ(9u, delta.words.size());
+  EXPECT_EQ(0u, primary.dirty_words());
+
+  tracked_bitset replica(1000);
+  replica.apply(delta);
+  EXPECT_EQ(primary.bits(), replica.bits());
+  EXPECT_EQ(9u, replica.dirty_words());
+  std::vector<std::size_t> runs;
+  replica.for_each_dirty_run([&runs](std::size_t first, std::size_t count) {
+    runs.push_back(first);
+    runs.push_back(count);
+  });
+  EXPECT_EQ(std::vector<std::size_t>({0, 3, 4, 5, 15, 1}), runs);
+  EXPECT_THROW(tracked_bitset(999).apply(delta), std::invalid_argument);
+}
+
+TEST(tracked_bitset_replication, BasicAssertions) {
+  const std::size_t size = 100000;
+  tracked_bitset primary(size);
+  for (std::size_t i = 0; i < 5000; ++i)
+    primary.set(bit_word::mix(i) % size);
+  word_bitset replica(size);
+  primary.checkpoint();
+  primary.snapshot().apply(replica);
+  EXPECT_EQ(primary.bits(), replica);
+
+  for (std::size_t round = 0; round < 10; ++round) {
+    for (std::size_t k = 0; k < 50; ++k)
+      primary.set(bit_word::mix(round * 100 + k + 7) % size, k % 3 != 0);
+    std::stringstream wire;
+    const bitset_delta delta = primary.checkpoint();
+    delta.write(wire);
+    EXPECT_EQ(delta.bytes(), wire.str().size());
+    // far smaller than the whole set
+    EXPECT_LT(delta.bytes(), size / 8 / 4);
+    bitset_delta::read(wire).apply(replica);
+    ASSERT_EQ(primary.bits(), replica);
+  }
+
+  std::stringstream truncated(std::string(12, '\0'));
+  EXPECT_THROW(bitset_delta::read(truncated), std::runtime_error);
+
+  // huge counts in a short input fail on the missing words, not on memory
+  bitset_delta huge;
+  huge.size = std::size_t(1) << 63;
+  huge.runs.push_back({0, std::size_t(1) << 57});
+  std::stringstream forged;
+  huge.write(forged);
+  EXPECT_THROW(bitset_delta::read(forged), std::runtime_error);
+
+  // runs that repeat words add up to more than the bitset
+  bitset_delta repeated;
+  repeated.size = 128;
+  repeated.runs = {{0, 2}, {0, 2}};
+  std::stringstream overlapping;
+  repeated.write(overlapping);
+  EXPECT_THROW(bitset_delta::read(overlapping), std::runtime_error);
+}
+
+TEST(tracked_bitset_bad_delta, BasicAssertions) {
+  word_bitset target(200);
+  target.set(5, true);
+  const word_bitset before = target;
+
+  // fewer words than the runs cover
+  bitset_delta short_words;
+  short_words.size = 200;
+  short_words.runs = {{0, 2}, {3, 1}};
+  short_words.words = {~0ULL, ~0ULL};
+  EXPECT_THROW(short_words.apply(target), std::invalid_argument);
+  EXPECT_EQ(before, target);
+
+  // a bad run after a good one leaves the target untouched
+  bitset_delta bad_run;
+  bad_run.size = 200;
+  bad_run.runs = {{0, 1}, {3, 2}};
+  bad_run.words = {~0ULL, ~0ULL, ~0ULL};
+  EXPECT_THROW(bad_run.apply(target), std::invalid_argument);
+  EXPECT_EQ(before, target);
+
+  bitset_delta extra_words = short_words;
+  extra_words.words.resize(4, 0);
+  EXPECT_THROW(extra_words.apply(target), std::invalid_argument);
+  extra_words.words.pop_back();
+  extra_words.apply(target);
+  EXPECT_EQ(128u, target.count());
+}
+
+TEST(tracked_bitset_dynamic, BasicAssertions) {
+  dynamic_bitset<> bits("0110");
+  tracked_bitset tracked(bits);
+  EXPECT_EQ(0u, tracked.dirty_words());
+  tracked.set(0);
+  EXPECT_EQ("1110", tracked.to_dynamic_bitset().to_string());
+  EXPECT_EQ(1u, tracked.snapshot().words.size());
+}
@@ -0,0 +1,81 @@
+#include "../Source/vertical_counter.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<word_bitset> sample_sets(std::size_t count, std::size_t bits) {
+  std::vector<word_bitset> sets;
+  for (std::size_t i = 0; i < count; ++i) {
+    word_bitset set(bits);
+    for (std::size_t b = 0; b < bits; ++b)
+      if (bit_word::mix(i * 7919 + b) % 3 == 0)
+        set.set(b, true);
+    sets.push_back(set);
+  }
+  return sets;
+}
+
+std::vector<std::uint32_t> reference_counts(const std::vector<word_bitset> &sets,
+                                            std::size_t bits) {
+  std::vector<std::uint32_t> counts(bits, 0);
+  for (const auto &set : sets)
+    for (std::size_t b = 0; b < bits; ++b)
+      counts[b] += set.test(b);
+  return counts;
+}
+} // namespace
+
+TEST(vertical_counter_counts, BasicAssertions) {
+  for (std::size_t n : {0u, 1u, 7u, 8u, 9u, 23u, 64u, 100u}) {
+    const auto sets = sample_sets(n, 200);
+    vertical_counter counter(sets);
+    EXPECT_EQ(n, counter.inputs());
+    const auto expected =
+        n ? reference_counts(sets, 200) : std::vector<std::uint32_t>();
+    EXPECT_EQ(expected, counter.counts());
+    if (n) {
+      EXPECT_EQ(expected[17], counter.count(17));
+    }
+  }
+}
+
+TEST(vertical_counter_thresholds, BasicAssertions) {
+  const std::size_t bits = 300;
+  const auto sets = sample_sets(25, bits);
+  const auto counts = reference_counts(sets, bits);
+  vertical_counter counter(sets);
+
+  for (std::size_t k : {0u, 1u, 5u, 8u, 13u, 25u, 26u}) {
+    const auto at_least = counter.at_least(k);
+    const auto at_most = counter.at_most(k);
+    const auto exactly = counter.exactly(k);
+    for (std::size_t b = 0; b < bits; ++b) {
+      EXPECT_EQ(counts[b] >= k, at_least.test(b));
+      EXPECT_EQ(counts[b] <= k, at_most.test(b));
+      EXPECT_EQ(counts[b] == k, exactly.test(b));
+    }
+  }
+  EXPECT_EQ(counter.at_least(13), counter.majority());
+}
+
+TEST(vertical_counter_sources, BasicAssertions) {
+  std::vector<dynamic_bitset<>> votes;
+  votes.emplace_back(std::string("11001"));
+  votes.emplace_back(std::string("10101"));
+  votes.emplace_back(std::string("10011"));
+  vertical_counter counter(votes);
+  EXPECT_EQ("10001", counter.majority().to_dynamic_bitset().to_string());
+  EXPECT_EQ((std::vector<std::uint32_t>{3, 1, 1, 1, 3}), counter.counts());
+
+  bitset_array rows(10, 70, bitset_layout::interleaved);
+  for (std::size_t r = 0; r < 10; ++r)
+    rows[r].set(r, true).set(69, true);
+  vertical_counter from_array(rows);
+  EXPECT_EQ(10u, from_array.count(69));
+  EXPECT_EQ(1u, from_array.count(3));
+  EXPECT_EQ(0u, from_array.count(30));
+  EXPECT_EQ(1u, from_array.at_least(2).count());
+
+  std::vector<word_bitset> mismatched = {word_bitset(10), word_bitset(11)};
+  EXPECT_THROW(vertical_counter{mismatched}, std::invalid_argument);
+}
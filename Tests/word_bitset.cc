@@ -0,0 +1,166 @@
+#include "../Source/word_bitset.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+word_bitset shifted_reference(const word_bitset &dst, const word_bitset &src,
+                              std::size_t shift) {
+  word_bitset result = dst;
+  for (std::size_t i = src.find_first(); i != bit_word::npos;
+       i = src.find_next(i))
+    if (i + shift < result.size())
+      result.set(i + shift, true);
+  return result;
+}
+} // namespace
+
+TEST(word_bitset_pack, BasicAssertions) {
+  dynamic_bitset<> x = std::string("1001011");
+  word_bitset packed(x);
+  EXPECT_EQ(7u, packed.size());
+  EXPECT_EQ(4u, packed.count());
+  EXPECT_EQ(x.to_string(), packed.to_dynamic_bitset().to_string());
+}
+
+TEST(word_bitset_range, BasicAssertions) {
+  word_bitset x(200);
+  x.set_range(60, 130, true);
+  EXPECT_EQ(70u, x.count());
+  EXPECT_EQ(60u, x.find_first());
+  EXPECT_EQ(129u, x.find_next(128));
+  EXPECT_EQ(bit_word::npos, x.find_next(129));
+
+  x.set_range(64, 128, false);
+  EXPECT_EQ(6u, x.count());
+  EXPECT_EQ(128u, x.find_next(63));
+
+  x.set(199, true);
+  EXPECT_EQ(bit_word::npos, x.find_next(199));
+  EXPECT_EQ(bit_word::npos, x.find_next(bit_word::npos));
+  EXPECT_EQ(bit_word::npos, word_bitset(0).find_next(0));
+  EXPECT_THROW(x.set_range(100, 201, true), std::out_of_range);
+  EXPECT_EQ(7u, x.count());
+}
+
+TEST(word_bitset_stride, BasicAssertions) {
+  word_bitset x(200);
+  x.set_stride(3, 100, 7, true);
+  EXPECT_EQ(14u, x.count());
+  EXPECT_EQ(3u, x.find_first());
+  EXPECT_EQ(10u, x.find_next(3));
+  EXPECT_EQ(94u, x.find_next(87));
+  EXPECT_EQ(bit_word::npos, x.find_next(94));
+
+  x.set(true);
+  x.set_stride(0, 200, 64, false);
+  EXPECT_EQ(196u, x.count());
+  EXPECT_FALSE(x.test(128));
+  EXPECT_THROW(x.set_stride(0, 10, 0, true), std::invalid_argument);
+  EXPECT_THROW(x.set_stride(0, 300, 7, false), std::out_of_range);
+  EXPECT_EQ(196u, x.count());
+}
+
+TEST(word_bitset_count_range, BasicAssertions) {
+  word_bitset x(200);
+  for (std::size_t i = 0; i < 200; i += 3)
+    x.set(i, true);
+  auto reference = [&x](std::size_t first, std::size_t last) {
+    std::size_t total = 0;
+    for (std::size_t i = first; i < last; ++i)
+      total += x.test(i);
+    return total;
+  };
+  // word aligned, unaligned and single word ranges
+  for (std::size_t first : {0u, 1u, 63u, 64u, 65u, 130u})
+    for (std::size_t last : {64u, 65u, 128u, 131u, 199u, 200u})
+      EXPECT_EQ(reference(first, last), x.count_range(first, last))
+          << first << " " << last;
+  EXPECT_EQ(x.count(), x.count_range(0, 200));
+  EXPECT_EQ(0u, x.count_range(90, 90));
+  EXPECT_EQ(0u, x.count_range(100, 50));
+  EXPECT_EQ(1u, x.count_range(198, 200));
+  EXPECT_EQ(0u, word_bitset(0).count_range(0, 0));
+  EXPECT_THROW(x.count_range(0, 201), std::out_of_range);
+}
+
+TEST(word_bitset_fill, BasicAssertions) {
+  word_bitset x(70, true);
+  EXPECT_TRUE(x.all());
+  EXPECT_EQ(70u, x.count());
+  x.flip();
+  EXPECT_TRUE(x.none());
+
+  x.resize(130);
+  x.set(true);
+  x.resize(65);
+  x.resize(130);
+  EXPECT_EQ(65u, x.count());
+}
+
+TEST(word_bitset_fused, BasicAssertions) {
+  word_bitset a(100), b(100), c(100);
+  for (std::size_t i = 0; i < 100; i += 2)
+    a.set(i, true);
+  for (std::size_t i = 0; i < 100; i += 3)
+    b.set(i, true);
+
+  EXPECT_EQ((a & b).count(), a.and_count(b));
+
+  c.or_and_not(a, b);
+  word_bitset expected = a;
+  expected.and_not(b);
+  EXPECT_EQ(expected, c);
+
+  c.reset();
+  c.or_and(a, b);
+  EXPECT_EQ(a & b, c);
+
+  std::vector<std::size_t> indexes;
+  (a & b).for_each([&indexes](std::size_t i) { indexes.push_back(i); });
+  EXPECT_EQ(17u, indexes.size());
+  EXPECT_EQ(96u, indexes.back());
+}
+
+TEST(word_bitset_estimate_count, BasicAssertions) {
+  word_bitset small(1000);
+  small.set_range(100, 400, true);
+  EXPECT_EQ(300u, small.estimate_count());
+
+  const std::size_t size = 1 << 24;
+  word_bitset large(size);
+  for (std::size_t i = 0; i < size; ++i)
+    if (bit_word::mix(i) % 10 < 3)
+      large.set(i, true);
+  const double exact = static_cast<double>(large.count());
+  EXPECT_NEAR(exact, static_cast<double>(large.estimate_count(0.01)),
+              0.01 * size);
+  EXPECT_NEAR(exact, static_cast<double>(large.estimate_count(0.05)),
+              0.05 * size);
+}
+
+TEST(word_bitset_or_shifted, BasicAssertions) {
+  word_bitset src(300);
+  for (std::size_t i = 0; i < 300; ++i)
+    if (bit_word::mix(i) % 3 == 0)
+      src.set(i, true);
+  word_bitset dst(250);
+  dst.set(5, true);
+  for (std::size_t shift : {0u, 1u, 63u, 64u, 65u, 130u, 249u, 250u, 400u}) {
+    word_bitset result = dst;
+    result.or_shifted(src, shift);
+    EXPECT_EQ(shifted_reference(dst, src, shift), result) << shift;
+
+    // shifting a set into itself
+    word_bitset self = src;
+    self.or_shifted(self, shift);
+    EXPECT_EQ(shifted_reference(src, src, shift), self) << shift;
+  }
+
+  // a smaller source spills into the word above it
+  word_bitset small(10);
+  small.set(9, true);
+  word_bitset wide(200);
+  wide.or_shifted(small, 60);
+  EXPECT_TRUE(wide.test(69));
+  EXPECT_EQ(1u, wide.count());
+}